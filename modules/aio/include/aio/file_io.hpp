@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include "core/future_result.hpp"
+
+namespace helios::aio {
+
+/**
+ * @class aio::FileIo
+ *
+ * @brief Reads and writes files asynchronously through io_uring.
+ *
+ * @details
+ * - Every operation returns a FutureResult holding the number of bytes
+ *   transferred, or a std::system_error if it failed. Callers on a loop
+ *   resume there with 'result->then(*this, ...)', so the loop never blocks
+ *   on the disk. Like read() and write(), an operation may transfer fewer
+ *   bytes than asked, e.g. from 4 GiB on, which one entry can't describe.
+ * - Submissions go straight to the kernel. One completion thread reaps the
+ *   completions and sets the results.
+ * - Registered buffers are pinned by the kernel once. The fixed reads and
+ *   writes use them without mapping the pages again on every operation.
+ * - If io_uring can't be set up, e.g. when it is blocked by seccomp, the
+ *   operations run as blocking calls on a thread of their own instead.
+ *
+ * @note
+ * - All public functions are thread-safe.
+ * - The buffers and file descriptors of an operation shall stay valid until
+ *   its result is set.
+ * - The destructor waits for the operations in flight.
+ */
+class FileIo {
+public:
+  /**
+   * @brief Type aliases.
+   */
+  using Result = core::FutureResult<std::size_t>;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param entries Size of the submission queue. The operations in flight
+   *        are limited to the size of the completion queue, twice as large.
+   */
+  explicit FileIo(unsigned entries = 256);
+
+  /**
+   * @brief Destructor.
+   */
+  ~FileIo();
+
+  /**
+   * @brief Delete copy and move semantics.
+   */
+  FileIo(const FileIo &) = delete;
+  FileIo &operator=(const FileIo &) = delete;
+  FileIo(FileIo &&) = delete;
+  FileIo &operator=(FileIo &&) = delete;
+
+  /**
+   * @brief Returns true if the operations go through io_uring.
+   */
+  bool usesIoUring() const;
+
+  /**
+   * @brief Reads from a file.
+   *
+   * @param fd File descriptor.
+   * @param buf Destination.
+   * @param len Number of bytes to read.
+   * @param offset Offset in the file.
+   *
+   * @return Number of bytes read. 0 at the end of the file.
+   */
+  Result::Ptr read(int fd, void *buf, std::size_t len, std::uint64_t offset);
+
+  /**
+   * @brief Writes to a file.
+   *
+   * @param fd File descriptor.
+   * @param buf Source.
+   * @param len Number of bytes to write.
+   * @param offset Offset in the file.
+   *
+   * @return Number of bytes written.
+   */
+  Result::Ptr write(int fd, const void *buf, std::size_t len,
+                    std::uint64_t offset);
+
+  /**
+   * @brief Registers the buffers of the fixed reads and writes.
+   *
+   * @param buffers Buffers, addressed by their index afterwards. Shall stay
+   *        valid until this object is destroyed.
+   *
+   * @return False if buffers are already registered or the kernel refuses
+   *         them, e.g. over the locked memory limit.
+   */
+  bool registerBuffers(const std::vector<iovec> &buffers);
+
+  /**
+   * @brief Reads from a file into the start of a registered buffer.
+   *
+   * @param fd File descriptor.
+   * @param index Index of the registered buffer.
+   * @param len Number of bytes to read. At most the size of the buffer.
+   * @param offset Offset in the file.
+   *
+   * @return Number of bytes read, or std::invalid_argument for a bad index
+   *         or length.
+   */
+  Result::Ptr readFixed(int fd, unsigned index, std::size_t len,
+                        std::uint64_t offset);
+
+  /**
+   * @brief Writes the start of a registered buffer to a file.
+   *
+   * @param fd File descriptor.
+   * @param index Index of the registered buffer.
+   * @param len Number of bytes to write. At most the size of the buffer.
+   * @param offset Offset in the file.
+   *
+   * @return Number of bytes written, or std::invalid_argument for a bad
+   *         index or length.
+   */
+  Result::Ptr writeFixed(int fd, unsigned index, std::size_t len,
+                         std::uint64_t offset);
+
+private:
+  /**
+   * @brief Forward declaration for the implementation class.
+   */
+  class Impl;
+
+  /**
+   * @brief Unique pointer to the implementation class.
+   */
+  std::unique_ptr<Impl> impl_;
+}; // class FileIo
+
+} // namespace helios::aio
@@ -0,0 +1,299 @@
+#include "aio/file_io.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <unistd.h>
+
+#include "core/h_loop.hpp"
+#include "ring.hpp"
+
+namespace {
+
+/**
+ * @brief Returns the length of a submission entry. Longer transfers are cut
+ *        short, as read() and write() may do anyway.
+ */
+std::uint32_t sqeLength(std::size_t len) {
+  return static_cast<std::uint32_t>(
+      std::min<std::size_t>(len, std::numeric_limits<std::uint32_t>::max())
+  );
+}
+
+} // namespace
+
+namespace helios::aio {
+
+class FileIo::Impl {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param entries Size of the submission queue.
+   */
+  explicit Impl(unsigned entries);
+
+  /**
+   * @brief Destructor.
+   */
+  ~Impl();
+
+  /**
+   * @brief Operation waiting for its completion.
+   */
+  struct Pending {
+    Result::Ptr result;
+  }; // struct Pending
+
+  /**
+   * @brief Kind of an operation.
+   */
+  enum class Op { Read, Write };
+
+  /**
+   * @brief io_uring instance.
+   */
+  Ring ring_;
+
+  /**
+   * @brief Runs the blocking calls if the ring is not set up.
+   */
+  std::shared_ptr<core::HLoop> fallback_;
+
+  /**
+   * @brief Completion thread of the ring.
+   */
+  std::thread t_;
+
+  /**
+   * @brief Protects the class.
+   */
+  std::mutex mtx_;
+
+  /**
+   * @brief Wakes the submitters waiting for a free completion entry.
+   */
+  std::condition_variable cv_;
+
+  /**
+   * @brief Operations submitted and not reaped yet.
+   */
+  unsigned inFlight_{0};
+
+  /**
+   * @brief Set to true to stop the completion thread.
+   */
+  bool stopping_{false};
+
+  /**
+   * @brief Registered buffers.
+   */
+  std::vector<iovec> buffers_;
+
+  /**
+   * @brief Sets the result of an operation from a byte count or a negative
+   *        errno.
+   */
+  static void complete(const Result::Ptr &result, std::int64_t res);
+
+  /**
+   * @brief Starts a plain read or write.
+   */
+  Result::Ptr start(Op op, int fd, void *buf, std::size_t len,
+                    std::uint64_t offset);
+
+  /**
+   * @brief Starts a read or write of a registered buffer.
+   */
+  Result::Ptr startFixed(Op op, int fd, unsigned index, std::size_t len,
+                         std::uint64_t offset);
+
+  /**
+   * @brief Submits an entry, waiting for a free completion entry first.
+   */
+  Result::Ptr submit(io_uring_sqe sqe);
+
+  /**
+   * @brief Runs an operation as a blocking call on the fallback loop.
+   */
+  Result::Ptr runBlocking(Op op, int fd, void *buf, std::size_t len,
+                          std::uint64_t offset);
+
+  /**
+   * @brief Main function of the completion thread.
+   */
+  void run();
+}; // class Impl
+
+FileIo::FileIo(unsigned entries) : impl_{std::make_unique<Impl>(entries)} {}
+
+FileIo::~FileIo() = default;
+
+bool FileIo::usesIoUring() const { return impl_->ring_.ok(); }
+
+FileIo::Result::Ptr FileIo::read(int fd, void *buf, std::size_t len,
+                                 std::uint64_t offset) {
+  return impl_->start(Impl::Op::Read, fd, buf, len, offset);
+}
+
+FileIo::Result::Ptr FileIo::write(int fd, const void *buf, std::size_t len,
+                                  std::uint64_t offset) {
+  return impl_->start(Impl::Op::Write, fd, const_cast<void *>(buf), len,
+                      offset);
+}
+
+bool FileIo::registerBuffers(const std::vector<iovec> &buffers) {
+  std::lock_guard<std::mutex> lock(impl_->mtx_);
+  if (!impl_->buffers_.empty() || buffers.empty())
+    return false;
+  if (impl_->ring_.ok() &&
+      impl_->ring_.registerBuffers(buffers.data(),
+                                   static_cast<unsigned>(buffers.size())) < 0)
+    return false;
+  impl_->buffers_ = buffers;
+  return true;
+}
+
+FileIo::Result::Ptr FileIo::readFixed(int fd, unsigned index, std::size_t len,
+                                      std::uint64_t offset) {
+  return impl_->startFixed(Impl::Op::Read, fd, index, len, offset);
+}
+
+FileIo::Result::Ptr FileIo::writeFixed(int fd, unsigned index,
+                                       std::size_t len, std::uint64_t offset) {
+  return impl_->startFixed(Impl::Op::Write, fd, index, len, offset);
+}
+
+FileIo::Impl::Impl(unsigned entries) : ring_(entries) {
+  if (!ring_.ok()) {
+    fallback_ = std::make_shared<core::HLoop>();
+    return;
+  }
+  t_ = std::thread([this] { run(); });
+}
+
+FileIo::Impl::~Impl() {
+  if (!ring_.ok())
+    return; // The fallback loop handles its queue before it stops
+
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stopping_ = true;
+  }
+  // Wakes the completion thread, which leaves once nothing is in flight.
+  // Unlike a submitted entry, this can't fail on a full ring.
+  ring_.wake();
+  t_.join();
+}
+
+void FileIo::Impl::complete(const Result::Ptr &result, std::int64_t res) {
+  if (res < 0) {
+    result->setException(std::make_exception_ptr(std::system_error(
+        static_cast<int>(-res), std::generic_category(), "File I/O failed"
+    )));
+  } else {
+    result->set(static_cast<std::size_t>(res));
+  }
+}
+
+FileIo::Result::Ptr FileIo::Impl::start(Op op, int fd, void *buf,
+                                        std::size_t len,
+                                        std::uint64_t offset) {
+  if (!ring_.ok())
+    return runBlocking(op, fd, buf, len, offset);
+  io_uring_sqe sqe{};
+  sqe.opcode = op == Op::Read ? IORING_OP_READ : IORING_OP_WRITE;
+  sqe.fd = fd;
+  sqe.addr = reinterpret_cast<std::uint64_t>(buf);
+  sqe.len = sqeLength(len);
+  sqe.off = offset;
+  return submit(sqe);
+}
+
+FileIo::Result::Ptr FileIo::Impl::startFixed(Op op, int fd, unsigned index,
+                                             std::size_t len,
+                                             std::uint64_t offset) {
+  iovec buffer{};
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (index < buffers_.size())
+      buffer = buffers_[index];
+  }
+  if (buffer.iov_base == nullptr || len > buffer.iov_len) {
+    auto result = Result::create();
+    result->setException(std::make_exception_ptr(
+        std::invalid_argument("Bad registered buffer or length")
+    ));
+    return result;
+  }
+  if (!ring_.ok())
+    return runBlocking(op, fd, buffer.iov_base, len, offset);
+  io_uring_sqe sqe{};
+  sqe.opcode = op == Op::Read ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+  sqe.fd = fd;
+  sqe.addr = reinterpret_cast<std::uint64_t>(buffer.iov_base);
+  sqe.len = sqeLength(len);
+  sqe.off = offset;
+  sqe.buf_index = static_cast<std::uint16_t>(index);
+  return submit(sqe);
+}
+
+FileIo::Result::Ptr FileIo::Impl::submit(io_uring_sqe sqe) {
+  auto result = Result::create();
+  auto pending = std::make_unique<Pending>(Pending{result});
+  sqe.user_data = reinterpret_cast<std::uint64_t>(pending.get());
+  int r;
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    // Bounded so that the completion queue never overflows
+    cv_.wait(lock, [this] { return inFlight_ < ring_.cqEntries(); });
+    r = ring_.submit(sqe);
+    if (r == 0) {
+      ++inFlight_;
+      pending.release(); // Owned by the ring until reaped
+    }
+  }
+  if (r < 0)
+    complete(result, r);
+  return result;
+}
+
+FileIo::Result::Ptr FileIo::Impl::runBlocking(Op op, int fd, void *buf,
+                                              std::size_t len,
+                                              std::uint64_t offset) {
+  auto result = Result::create();
+  fallback_->post([=] {
+    const auto off = static_cast<off_t>(offset);
+    const ssize_t n = op == Op::Read ? ::pread(fd, buf, len, off)
+                                     : ::pwrite(fd, buf, len, off);
+    complete(result, n < 0 ? -errno : n);
+  });
+  return result;
+}
+
+void FileIo::Impl::run() {
+  while (true) {
+    ring_.waitCompletion();
+    unsigned done{0};
+    ring_.reap([&done](const io_uring_cqe &cqe) {
+      std::unique_ptr<Pending> pending(
+          reinterpret_cast<Pending *>(cqe.user_data)
+      );
+      complete(pending->result, cqe.res);
+      ++done;
+    });
+    std::lock_guard<std::mutex> lock(mtx_);
+    inFlight_ -= done;
+    cv_.notify_all();
+    if (stopping_ && inFlight_ == 0)
+      break;
+  }
+}
+
+} // namespace helios::aio
@@ -0,0 +1,160 @@
+#include "ring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Wrappers of the system calls, which glibc doesn't provide.
+ */
+int ioUringSetup(unsigned entries, io_uring_params *p) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete,
+                 unsigned flags) {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit,
+                                    minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void *arg,
+                    unsigned count) {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_register, fd, opcode, arg, count)
+  );
+}
+
+/**
+ * @brief Returns a field of a mapped ring.
+ */
+template <typename T> T *at(void *base, std::uint32_t offset) {
+  return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+}
+
+} // namespace
+
+namespace helios::aio {
+
+Ring::Ring(unsigned entries) {
+  io_uring_params p{};
+  fd_ = ioUringSetup(entries, &p);
+  if (fd_ < 0) {
+    fd_ = -1; // Blocked by seccomp or not built into the kernel
+    return;
+  }
+  cqEntries_ = p.cq_entries;
+
+  sqRingSize_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  cqRingSize_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+  const bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+  if (single)
+    sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+  sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+  if (sqRing_ == MAP_FAILED) {
+    sqRing_ = nullptr;
+    release();
+    return;
+  }
+  if (single) {
+    cqRing_ = sqRing_;
+  } else {
+    cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+    if (cqRing_ == MAP_FAILED) {
+      cqRing_ = nullptr;
+      release();
+      return;
+    }
+  }
+  sqesSize_ = p.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    release();
+    return;
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+  wakeFd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wakeFd_ < 0) {
+    release();
+    return;
+  }
+
+  sqTail_ = at<unsigned>(sqRing_, p.sq_off.tail);
+  sqMask_ = at<unsigned>(sqRing_, p.sq_off.ring_mask);
+  sqArray_ = at<unsigned>(sqRing_, p.sq_off.array);
+  cqHead_ = at<unsigned>(cqRing_, p.cq_off.head);
+  cqTail_ = at<unsigned>(cqRing_, p.cq_off.tail);
+  cqMask_ = at<unsigned>(cqRing_, p.cq_off.ring_mask);
+  cqes_ = at<io_uring_cqe>(cqRing_, p.cq_off.cqes);
+}
+
+Ring::~Ring() { release(); }
+
+int Ring::submit(const io_uring_sqe &sqe) {
+  // Without SQPOLL the kernel consumes the entry in io_uring_enter(), so the
+  // submission queue never holds more than one entry
+  const unsigned tail = *sqTail_;
+  const unsigned index = tail & *sqMask_;
+  sqes_[index] = sqe;
+  sqArray_[index] = index;
+  store(sqTail_, tail + 1);
+  int r;
+  do {
+    r = ioUringEnter(fd_, 1, 0, 0);
+  } while (r < 0 && errno == EINTR);
+  if (r > 0)
+    return 0;
+  const int err = r < 0 ? errno : EAGAIN;
+  store(sqTail_, tail); // Not consumed, take it back
+  return -err;
+}
+
+void Ring::waitCompletion() {
+  if (load(cqTail_) != *cqHead_)
+    return;
+  // The ring file descriptor is readable while completions are available
+  pollfd fds[2]{{fd_, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+  ::poll(fds, 2, -1); // EINTR is a wake-up too
+  if (fds[1].revents & POLLIN) {
+    std::uint64_t count;
+    (void)::read(wakeFd_, &count, sizeof(count)); // Consume the wake-up
+  }
+}
+
+void Ring::wake() {
+  const std::uint64_t one{1};
+  (void)::write(wakeFd_, &one, sizeof(one));
+}
+
+int Ring::registerBuffers(const void *iovecs, unsigned count) {
+  const int r = ioUringRegister(fd_, IORING_REGISTER_BUFFERS, iovecs, count);
+  return r < 0 ? -errno : 0;
+}
+
+void Ring::release() {
+  if (sqes_)
+    ::munmap(sqes_, sqesSize_);
+  if (cqRing_ && cqRing_ != sqRing_)
+    ::munmap(cqRing_, cqRingSize_);
+  if (sqRing_)
+    ::munmap(sqRing_, sqRingSize_);
+  if (fd_ >= 0)
+    ::close(fd_);
+  if (wakeFd_ >= 0)
+    ::close(wakeFd_);
+  sqes_ = nullptr;
+  sqRing_ = cqRing_ = nullptr;
+  fd_ = wakeFd_ = -1;
+}
+
+} // namespace helios::aio
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <linux/io_uring.h>
+
+namespace helios::aio {
+
+/**
+ * @class aio::Ring
+ *
+ * @brief io_uring instance set up with the raw system calls.
+ *
+ * @details
+ * - Maps the submission queue, the completion queue and the submission
+ *   entries into the process. The kernel and the process share the ring
+ *   heads and tails, which are accessed with acquire and release ordering.
+ * - No thread polls the rings. Submissions are handed to the kernel with
+ *   io_uring_enter() right away.
+ *
+ * @note
+ * - Not thread-safe. Submitting and reaping may happen on different threads,
+ *   as long as each is done by one thread at a time.
+ */
+class Ring {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param entries Size of the submission queue.
+   *
+   * @note
+   * - ok() tells if the ring could be set up.
+   */
+  explicit Ring(unsigned entries);
+
+  /**
+   * @brief Destructor.
+   */
+  ~Ring();
+
+  /**
+   * @brief Delete copy and move semantics.
+   */
+  Ring(const Ring &) = delete;
+  Ring &operator=(const Ring &) = delete;
+  Ring(Ring &&) = delete;
+  Ring &operator=(Ring &&) = delete;
+
+  /**
+   * @brief Returns true if the ring is set up.
+   */
+  bool ok() const { return fd_ >= 0; }
+
+  /**
+   * @brief Returns the size of the completion queue.
+   */
+  unsigned cqEntries() const { return cqEntries_; }
+
+  /**
+   * @brief Submits an entry.
+   *
+   * @return 0 or a negative errno.
+   */
+  int submit(const io_uring_sqe &sqe);
+
+  /**
+   * @brief Blocks until at least one completion is available or wake() is
+   *        called.
+   */
+  void waitCompletion();
+
+  /**
+   * @brief Wakes waitCompletion() without a completion. May be called from
+   *        any thread.
+   */
+  void wake();
+
+  /**
+   * @brief Calls 'fn' for every available completion and consumes them.
+   *
+   * @return Number of completions.
+   */
+  template <typename Fn> unsigned reap(Fn &&fn) {
+    unsigned head = *cqHead_;
+    const unsigned tail = load(cqTail_);
+    const unsigned count = tail - head;
+    for (; head != tail; ++head)
+      fn(cqes_[head & *cqMask_]);
+    store(cqHead_, head); // The entries may be reused by the kernel
+    return count;
+  }
+
+  /**
+   * @brief Registers buffers for the fixed reads and writes.
+   *
+   * @return 0 or a negative errno.
+   */
+  int registerBuffers(const void *iovecs, unsigned count);
+
+private:
+  /**
+   * @brief Ring file descriptor.
+   */
+  int fd_{-1};
+
+  /**
+   * @brief Eventfd signaled by wake().
+   */
+  int wakeFd_{-1};
+
+  /**
+   * @brief Size of the completion queue.
+   */
+  unsigned cqEntries_{0};
+
+  /**
+   * @brief Mappings of the rings and the submission entries.
+   */
+  void *sqRing_{nullptr};
+  void *cqRing_{nullptr};
+  std::size_t sqRingSize_{0};
+  std::size_t cqRingSize_{0};
+  io_uring_sqe *sqes_{nullptr};
+  std::size_t sqesSize_{0};
+
+  /**
+   * @brief Fields of the submission ring.
+   */
+  unsigned *sqTail_{nullptr};
+  unsigned *sqMask_{nullptr};
+  unsigned *sqArray_{nullptr};
+
+  /**
+   * @brief Fields of the completion ring.
+   */
+  unsigned *cqHead_{nullptr};
+  unsigned *cqTail_{nullptr};
+  unsigned *cqMask_{nullptr};
+  io_uring_cqe *cqes_{nullptr};
+
+  /**
+   * @brief Accesses a field shared with the kernel.
+   */
+  static unsigned load(unsigned *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+  }
+  static void store(unsigned *p, unsigned v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+  }
+
+  /**
+   * @brief Unmaps the rings and closes the file descriptor.
+   */
+  void release();
+}; // class Ring
+
+} // namespace helios::aio
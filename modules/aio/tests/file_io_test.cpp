@@ -0,0 +1,188 @@
+#include "aio/file_io.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <future>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "core/h_loop.hpp"
+#include "core/in_active_h_object.hpp"
+
+namespace {
+
+/**
+ * @brief Temporary file removed on destruction.
+ */
+class TempFile {
+public:
+  TempFile() {
+    char path[] = "/tmp/helios_aio_XXXXXX";
+    fd_ = ::mkstemp(path);
+    path_ = path;
+  }
+  ~TempFile() {
+    ::close(fd_);
+    ::unlink(path_.c_str());
+  }
+  int fd() const { return fd_; }
+
+private:
+  int fd_;
+  std::string path_;
+}; // class TempFile
+
+class Loader : public helios::core::InActiveHObject {
+public:
+  Loader(std::shared_ptr<helios::core::HLoop> loop, helios::aio::FileIo &io)
+      : helios::core::InActiveHObject(loop), io_(io) {}
+  std::future<std::string> load(int fd, std::size_t len) {
+    post([this, fd, len] {
+      buf_.assign(len, '\0');
+      io_.read(fd, buf_.data(), len, 0) THEN_POST({
+        if (runsInCurrentThread())
+          pr_.set_value(buf_.substr(0, *result));
+      });
+    });
+    return pr_.get_future();
+  }
+
+private:
+  helios::aio::FileIo &io_;
+  std::string buf_;
+  std::promise<std::string> pr_;
+}; // class Loader
+
+} // namespace
+
+/**
+ * @brief Data written to a file is read back.
+ */
+TEST(FileIoTest, WriteThenRead) {
+  helios::aio::FileIo io;
+  TempFile file;
+  ASSERT_GE(file.fd(), 0);
+  const std::string data = "hello io_uring";
+  auto written = io.write(file.fd(), data.data(), data.size(), 0)->get();
+  ASSERT_NE(written, std::nullopt);
+  EXPECT_EQ(*written, data.size());
+  std::string buf(data.size(), '\0');
+  auto read = io.read(file.fd(), buf.data(), buf.size(), 0)->get();
+  ASSERT_NE(read, std::nullopt);
+  EXPECT_EQ(*read, data.size());
+  EXPECT_EQ(buf, data);
+  // At the end of the file
+  EXPECT_EQ(io.read(file.fd(), buf.data(), buf.size(), data.size())->get(),
+            std::size_t{0});
+}
+
+/**
+ * @brief A length from 4 GiB on is cut short instead of wrapping around.
+ *
+ * @details
+ * - The buffer is an anonymous mapping of 4 GiB + 1 without reserved
+ *   memory, so only the pages the read touches are allocated.
+ * - Skipped when the mapping is refused.
+ */
+TEST(FileIoTest, LongLengthIsCutShort) {
+  constexpr std::size_t LEN{(std::size_t{1} << 32) + 1};
+  void *p = ::mmap(nullptr, LEN, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (p == MAP_FAILED)
+    GTEST_SKIP() << "Can't map a buffer of 4 GiB";
+  helios::aio::FileIo io;
+  TempFile file;
+  ASSERT_GE(file.fd(), 0);
+  const std::string data = "longer than one byte";
+  ASSERT_EQ(::pwrite(file.fd(), data.data(), data.size(), 0),
+            static_cast<ssize_t>(data.size()));
+  // Wrapped to 32 bits, the length would be 1
+  EXPECT_EQ(io.read(file.fd(), p, LEN, 0)->get(), data.size());
+  EXPECT_EQ(std::string(static_cast<const char *>(p), data.size()), data);
+  ::munmap(p, LEN);
+}
+
+/**
+ * @brief A failed operation sets the errno as a std::system_error.
+ */
+TEST(FileIoTest, ErrorIsReported) {
+  helios::aio::FileIo io;
+  char buf[8];
+  try {
+    io.read(-1, buf, sizeof(buf), 0)->get();
+    FAIL() << "Expected std::system_error";
+  } catch (const std::system_error &e) {
+    EXPECT_EQ(e.code().value(), EBADF);
+  }
+}
+
+/**
+ * @brief The fixed reads and writes go through the registered buffers.
+ *
+ * @details
+ * - Skipped when the kernel refuses to pin the buffers.
+ */
+TEST(FileIoTest, RegisteredBuffers) {
+  helios::aio::FileIo io;
+  std::vector<char> in(4096, 'x');
+  std::vector<char> out(4096, '\0');
+  if (!io.registerBuffers({{in.data(), in.size()}, {out.data(), out.size()}}))
+    GTEST_SKIP() << "Buffers can't be registered";
+  EXPECT_FALSE(io.registerBuffers({{in.data(), in.size()}}));
+  TempFile file;
+  ASSERT_GE(file.fd(), 0);
+  EXPECT_EQ(io.writeFixed(file.fd(), 0, in.size(), 0)->get(), in.size());
+  EXPECT_EQ(io.readFixed(file.fd(), 1, out.size(), 0)->get(), out.size());
+  EXPECT_EQ(in, out);
+  // Bad index and length
+  EXPECT_THROW(io.readFixed(file.fd(), 2, 1, 0)->get(),
+               std::invalid_argument);
+  EXPECT_THROW(io.readFixed(file.fd(), 1, out.size() + 1, 0)->get(),
+               std::invalid_argument);
+}
+
+/**
+ * @brief The continuation of an operation resumes on the loop of the caller.
+ */
+TEST(FileIoTest, ResumesOnCallerLoop) {
+  helios::aio::FileIo io;
+  TempFile file;
+  ASSERT_GE(file.fd(), 0);
+  const std::string data = "resumed";
+  ASSERT_EQ(io.write(file.fd(), data.data(), data.size(), 0)->get(),
+            data.size());
+  auto loop = std::make_shared<helios::core::HLoop>();
+  Loader loader(loop, io);
+  auto loaded = loader.load(file.fd(), 64);
+  ASSERT_EQ(loaded.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  EXPECT_EQ(loaded.get(), data);
+}
+
+/**
+ * @brief More operations than the completion queue holds all complete.
+ */
+TEST(FileIoTest, ManyOperationsInFlight) {
+  helios::aio::FileIo io(4);
+  TempFile file;
+  ASSERT_GE(file.fd(), 0);
+  std::vector<char> data(256);
+  for (std::size_t i{}; i < data.size(); ++i)
+    data[i] = static_cast<char>(i);
+  std::vector<helios::aio::FileIo::Result::Ptr> results;
+  for (std::size_t i{}; i < data.size(); ++i)
+    results.push_back(io.write(file.fd(), &data[i], 1, i));
+  for (auto &r : results)
+    EXPECT_EQ(r->get(), std::size_t{1});
+  std::vector<char> back(data.size());
+  EXPECT_EQ(io.read(file.fd(), back.data(), back.size(), 0)->get(),
+            back.size());
+  EXPECT_EQ(back, data);
+}
@@ -1,29 +1,61 @@
 #pragma once
 
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <exception>
+#include <functional>
+#include <optional>
 #include <thread>
+#include <vector>
 
+#include "clock.hpp"
 #include "event.hpp"
+#include "executor.hpp"
 #include "future_result.hpp"
 #include "h_object.hpp"
 
 namespace helios::core {
 
-#define REQ(RETURN_TYPE, BODY)                                         \
+class Reactor;
+
+#define REQ_IMPL(POST, RETURN_TYPE, BODY)                                      \
   [&]() -> helios::core::FutureResult<RETURN_TYPE>::Ptr {                      \
-    auto fut = std::make_shared<helios::core::FutureResult<RETURN_TYPE>>();    \
-    post([=]() mutable BODY);                                                  \
+    auto fut = helios::core::FutureResult<RETURN_TYPE>::create();              \
+    POST([=]() mutable {                                                       \
+      try BODY catch (...) {                                                   \
+        fut->setException(std::current_exception());                           \
+      }                                                                        \
+    });                                                                        \
     return fut;                                                                \
   }()
 
-#define REQ_CALLABLE(RETURN_TYPE, FUNC)                                \
+#define REQ_CALLABLE_IMPL(POST, RETURN_TYPE, FUNC)                             \
   [&]() -> helios::core::FutureResult<RETURN_TYPE>::Ptr {                      \
-    auto fut = std::make_shared<helios::core::FutureResult<RETURN_TYPE>>();    \
-    post([=, FUNC = FUNC]() mutable { FUNC(fut); });                           \
+    auto fut = helios::core::FutureResult<RETURN_TYPE>::create();              \
+    POST([=, FUNC = FUNC]() mutable {                                          \
+      try {                                                                    \
+        FUNC(fut);                                                             \
+      } catch (...) {                                                          \
+        fut->setException(std::current_exception());                           \
+      }                                                                        \
+    });                                                                        \
     return fut;                                                                \
   }()
 
+#define REQ(RETURN_TYPE, BODY) REQ_IMPL(post, RETURN_TYPE, BODY)
+
+#define REQ_CALLABLE(RETURN_TYPE, FUNC)                                        \
+  REQ_CALLABLE_IMPL(post, RETURN_TYPE, FUNC)
+
+// Same as REQ but runs the body directly, returning a ready result, if the
+// caller already runs in the thread of the object.
+#define REQ_INLINE(RETURN_TYPE, BODY) REQ_IMPL(dispatch, RETURN_TYPE, BODY)
+
+#define REQ_INLINE_CALLABLE(RETURN_TYPE, FUNC)                                 \
+  REQ_CALLABLE_IMPL(dispatch, RETURN_TYPE, FUNC)
+
 /**
  * @class core::ActiveHObject
  *
@@ -32,26 +64,68 @@ namespace helios::core {
  * @details
  * - Provides the derived classes with asynchronous event handling using the
  *   post() function.
+ * - Events can be delayed with postAfter() and postAt(). They run on the loop
+ *   thread like the other events, so no timer thread is needed. The loop
+ *   sleeps until the next deadline when nothing else is queued.
+ * - Deadlines follow the clock given on construction. With a VirtualClock,
+ *   the loop thread is one of its participants.
+ * - With the Epoll engine, the loop thread sleeps in epoll_wait() and also
+ *   runs readiness callbacks of watched file descriptors, so I/O and events
+ *   are served by one thread. Posts from other threads wake it through an
+ *   eventfd.
  * - During construction, the thread which runs the event queue is created.
+ *   Host-driven objects have no thread. The thread that constructs them runs
+ *   the queue through runOnce(), runFor() and poll() instead.
  * - During destruction, all events in the queue are executed first and then the
- *   object is destroyed.
+ *   object is destroyed. Delayed events that are not due yet are dropped.
+ * - Acts as an executor so that FutureResult continuations can be queued
+ *   directly onto its event queue.
  *
  * @note
  * - All public functions are asynchronous except the post() function which must
  *   be synchronous since it is communicating with the event queue.
  * - All public functions are thread-safe.
  */
-class ActiveHObject : public HObject {
+class ActiveHObject : public HObject, public Executor {
 public:
+  /**
+   * @brief Ways the loop thread sleeps while there is nothing to do.
+   * - CondVar: On a condition variable, through the clock.
+   * - Epoll: In epoll_wait(), watching file descriptors as well.
+   */
+  enum class Engine { CondVar, Epoll };
+
+  /**
+   * @brief Callback of a watched file descriptor, given the ready epoll
+   *        events.
+   */
+  using IoCallback = std::function<void(std::uint32_t events)>;
+
+  /**
+   * @brief Handler of the exceptions thrown by events.
+   */
+  using ErrorHandler = std::function<void(std::exception_ptr)>;
+
   /**
    * @brief Constructor.
    *
    * @param hBus Optional shared pointer to the signal bus.
+   * @param clock Optional clock of the delayed events. Defaults to a
+   *        SteadyClock.
+   * @param engine How the loop thread sleeps.
+   *
+   * @throws std::invalid_argument if the Epoll engine is given a clock other
+   *         than a SteadyClock.
+   * @throws std::system_error if the Epoll engine can't be set up.
    *
    * @note
    * - Blocks until the event is started and then returns.
    */
-  ActiveHObject(std::shared_ptr<HBus> hBus = nullptr);
+  ActiveHObject(std::shared_ptr<HBus> hBus = nullptr,
+                std::shared_ptr<Clock> clock = nullptr,
+                Engine engine = Engine::CondVar)
+      : ActiveHObject(std::move(hBus), std::move(clock), engine,
+                      Driver::Thread) {}
 
   /**
    * @brief Destructor.
@@ -69,7 +143,53 @@ public:
   ActiveHObject(ActiveHObject &&) = delete;
   ActiveHObject &operator=(ActiveHObject &&) = delete;
 
+  /**
+   * @brief Returns true if called from the loop thread.
+   */
+  bool runsInCurrentThread() const override;
+
+  /**
+   * @brief Sets the handler of the exceptions thrown by events.
+   *
+   * @details
+   * - The handler runs on the loop thread right after the failed event. The
+   *   remaining events run as usual.
+   * - Without a handler, the exception is printed to the standard error.
+   *
+   * @param handler Handler. Shall not throw.
+   */
+  void onError(ErrorHandler handler);
+
+  /**
+   * @brief Returns the clock of the delayed events.
+   */
+  Clock &clock() const { return *clock_; }
+
 protected:
+  /**
+   * @brief Who runs the event queue.
+   * - Thread: A loop thread owned by the object.
+   * - Host: The thread that constructed the object, by calling runOnce(),
+   *   runFor() or poll().
+   */
+  enum class Driver { Thread, Host };
+
+  /**
+   * @brief Constructor.
+   *
+   * @param hBus Optional shared pointer to the signal bus.
+   * @param clock Optional clock of the delayed events. Defaults to a
+   *        SteadyClock.
+   * @param engine How the loop thread sleeps.
+   * @param driver Who runs the event queue.
+   *
+   * @throws std::invalid_argument if the Epoll engine is given a clock other
+   *         than a SteadyClock.
+   * @throws std::system_error if the Epoll engine can't be set up.
+   */
+  ActiveHObject(std::shared_ptr<HBus> hBus, std::shared_ptr<Clock> clock,
+                Engine engine, Driver driver);
+
   /**
    * @brief Posts an event to the queue.
    *
@@ -81,12 +201,235 @@ protected:
     postImpl(std::forward<EventT>(e));
   }
 
+  /**
+   * @brief Posts an event that runs once a delay has passed.
+   *
+   * @tparam EventT Type of event to be posted.
+   * @param delay Delay from now.
+   * @param e Event to be posted.
+   */
+  template <typename EventT>
+  void postAfter(Clock::Duration delay, EventT &&e) {
+    postAtImpl(clock_->now() + delay, std::forward<EventT>(e));
+  }
+
+  /**
+   * @brief Posts an event that runs once a time point is reached.
+   *
+   * @details
+   * - Events due at the same time run in the order they were posted.
+   *
+   * @tparam EventT Type of event to be posted.
+   * @param due Time point when the event runs.
+   * @param e Event to be posted.
+   */
+  template <typename EventT>
+  void postAt(Clock::TimePoint due, EventT &&e) {
+    postAtImpl(due, std::forward<EventT>(e));
+  }
+
+  /**
+   * @brief Posts an event that runs once a time point is reached, on behalf
+   *        of an owner that can erase it with eraseTimers().
+   *
+   * @tparam EventT Type of event to be posted.
+   * @param due Time point when the event runs.
+   * @param owner Key of the owner.
+   * @param e Event to be posted.
+   */
+  template <typename EventT>
+  void postAt(Clock::TimePoint due, const void *owner, EventT &&e) {
+    postAtImpl(due, std::forward<EventT>(e), owner);
+  }
+
+  /**
+   * @brief Erases the delayed events of an owner that are not taken for a
+   *        batch yet, which releases their captures right away.
+   *
+   * @details
+   * - Those already taken for the running batch still run. The owner guards
+   *   them itself if needed.
+   *
+   * @param owner Key given to postAt().
+   */
+  void eraseTimers(const void *owner);
+
+  /**
+   * @brief Runs an event directly if called from the loop thread, otherwise
+   *        posts it to the queue.
+   *
+   * @tparam EventT Type of event to be dispatched.
+   * @param e Event to be dispatched.
+   *
+   * @note
+   * - A directly run event overtakes the events already in the queue.
+   */
+  template <typename EventT>
+  void dispatch(EventT &&e) {
+    if (runsInCurrentThread())
+      e();
+    else
+      postImpl(std::forward<EventT>(e));
+  }
+
+  /**
+   * @brief Starts watching a file descriptor.
+   *
+   * @details
+   * - The callback runs on the loop thread whenever the descriptor is ready.
+   * - Once unwatched, no callback runs for readiness reported later, but a
+   *   callback already queued may still run.
+   *
+   * @param fd File descriptor.
+   * @param events Epoll events to watch, e.g. EPOLLIN.
+   * @param cb Callback of the descriptor.
+   *
+   * @return False if the engine is not Epoll, the descriptor is already
+   *         watched or epoll refuses it.
+   */
+  bool watch(int fd, std::uint32_t events, IoCallback cb);
+
+  /**
+   * @brief Changes the events of a watched file descriptor.
+   *
+   * @return False if the descriptor is not watched or epoll refuses it.
+   */
+  bool modify(int fd, std::uint32_t events);
+
+  /**
+   * @brief Stops watching a file descriptor. Shall be called before the
+   *        descriptor is closed.
+   *
+   * @return False if the descriptor is not watched.
+   */
+  bool unwatch(int fd);
+
+  /**
+   * @brief Blocks until the events posted so far are handled.
+   *
+   * @details
+   * - Derived classes whose events use their own members call it in their
+   *   destructor, since those members are destroyed before this class.
+   *
+   * @note
+   * - Shall not be called from the loop thread. On the host thread of the
+   *   Host driver, it runs the events itself instead of blocking.
+   */
+  void drain();
+
+  /**
+   * @brief Drops the delayed events that did not run yet.
+   *
+   * @details
+   * - Runs on the loop thread behind the events posted so far, so it waits
+   *   for them like drain(). Called from the loop thread, it drops them
+   *   right away, including those left in the running batch.
+   * - Delayed events posted afterwards run as usual.
+   * - Derived classes whose delayed events use their own members call it in
+   *   their destructor before drain().
+   *
+   * @note
+   * - On the host thread of the Host driver, it never blocks.
+   */
+  void cancelTimers();
+
+  /**
+   * @brief Waits for events and runs one batch of them.
+   *
+   * @return Number of events run.
+   *
+   * @note
+   * - For the Host driver only. Called from the host thread.
+   */
+  std::size_t runOnce();
+
+  /**
+   * @brief Runs events as they come until a duration has passed on the
+   *        clock.
+   *
+   * @param duration Duration to run for.
+   *
+   * @return Number of events run.
+   *
+   * @note
+   * - For the Host driver only. Called from the host thread.
+   * - The duration passes on the clock of the object. A VirtualClock jumps
+   *   only while all its participants are idle, so runFor() doesn't return
+   *   while another participant stays busy or other threads keep posting.
+   *   runOnce() and poll() don't wait for the clock.
+   */
+  std::size_t runFor(Clock::Duration duration);
+
+  /**
+   * @brief Runs the queued events, the callbacks of the ready file
+   *        descriptors and the due delayed events without waiting.
+   *
+   * @return Number of events run.
+   *
+   * @note
+   * - For the Host driver only. Called from the host thread.
+   */
+  std::size_t poll();
+
+  /**
+   * @brief Returns a file descriptor that becomes readable when poll() has
+   *        events to run, other than the delayed ones.
+   *
+   * @return -1 unless the engine is Epoll.
+   */
+  int pollFd() const;
+
+  /**
+   * @brief Returns how long the host may wait on pollFd() before calling
+   *        poll(), so that the delayed events are not late.
+   *
+   * @return Milliseconds, rounded up. 0 if events are queued and -1 if
+   *         nothing is pending.
+   */
+  int pollTimeout();
+
 private:
+  /**
+   * @brief Event delayed until a time point.
+   */
+  struct TimedEvent {
+    Clock::TimePoint due;
+    std::uint64_t seq; // Keeps the posting order of equal deadlines
+    const void *owner; // Null for the events of this object
+    Event event;
+  }; // struct TimedEvent
+
+  /**
+   * @brief Clock of the delayed events.
+   */
+  std::shared_ptr<Clock> clock_;
+
+  /**
+   * @brief Epoll set of the Epoll engine. Null for the CondVar engine.
+   */
+  std::unique_ptr<Reactor> reactor_;
+
+  /**
+   * @brief Who runs the event queue.
+   */
+  const Driver driver_;
+
+  /**
+   * @brief Readiness callbacks collected while sleeping. Used by the loop
+   *        thread only.
+   */
+  std::deque<Event> ready_;
+
   /**
    * @brief Loop thread that runs the event queue.
    */
   std::thread t_;
 
+  /**
+   * @brief ID of the loop thread.
+   */
+  std::thread::id loopThreadId_;
+
   /**
    * @brief Set to true to stop the thread.
    */
@@ -107,17 +450,106 @@ private:
    */
   std::deque<Event> q_;
 
+  /**
+   * @brief Min-heap of the delayed events by deadline.
+   */
+  std::vector<TimedEvent> timers_;
+
+  /**
+   * @brief Sequence number of the last delayed event.
+   */
+  std::uint64_t timerSeq_{0};
+
+  /**
+   * @brief Set by cancelTimers() to skip the delayed events left in the
+   *        running batch. Used by the loop thread only.
+   */
+  bool timersCancelled_{false};
+
+  /**
+   * @brief Handler of the exceptions thrown by events.
+   */
+  ErrorHandler errorHandler_;
+
+  /**
+   * @brief Events being handled. Reused between batches so that swapping
+   *        with the queue keeps recycling the same buffers.
+   */
+  std::deque<Event> snapshot_;
+
   /**
    * @brief Function that runs in the loop thread.
    */
   void run();
 
+  /**
+   * @brief Takes the events to run as one batch and runs them.
+   *
+   * @param until Time after which it stops waiting. Nothing to wait as long
+   *        as needed.
+   * @param wait Set to false to run only what is ready.
+   *
+   * @return Number of events run. Nothing if the loop is stopped.
+   */
+  std::optional<std::size_t> runEvents(std::optional<Clock::TimePoint> until,
+                                       bool wait);
+
   /**
    * @brief Posts an event to the queue.
    *
    * @param e Event to be posted.
    */
   void postImpl(Event e);
+
+  /**
+   * @brief Adds a delayed event and wakes the loop thread if it is the
+   *        earliest one.
+   *
+   * @param due Time point when the event runs.
+   * @param e Event to be posted.
+   * @param owner Key of the owner. Null for the events of this object.
+   */
+  void postAtImpl(Clock::TimePoint due, Event e,
+                  const void *owner = nullptr);
+
+  /**
+   * @brief Posts a marker behind the queued events and blocks until it ran.
+   *
+   * @param cancel Set to true to drop the delayed events in the marker.
+   */
+  void sync(bool cancel);
+
+  /**
+   * @brief Drops the delayed events. Called from the loop thread.
+   */
+  void dropTimers();
+
+  /**
+   * @brief Hands the exception of a failed event to the error handler.
+   */
+  void report(std::exception_ptr error);
+
+  /**
+   * @brief Wakes the loop thread.
+   */
+  void wakeLoop();
+
+  /**
+   * @brief Sleeps until woken, a deadline or, for the Epoll engine, a ready
+   *        file descriptor.
+   *
+   * @param lock Lock of the class. Held on entry and on return.
+   * @param due Deadline. Nothing to sleep until woken.
+   */
+  void sleepLoop(std::unique_lock<std::mutex> &lock,
+                 std::optional<Clock::TimePoint> due);
+
+  /**
+   * @brief Posts a FutureResult continuation to the queue.
+   *
+   * @param e Event to be posted.
+   */
+  void execute(Event e) override;
 }; // class ActiveHObject
 
 } // namespace helios::core
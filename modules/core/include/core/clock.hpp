@@ -0,0 +1,172 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace helios::core {
+
+/**
+ * @class core::Clock
+ *
+ * @brief Source of time of the event loops and the timers.
+ *
+ * @details
+ * - The threads that wait for deadlines of this clock are its participants.
+ *   A participant is attached with the condition variable it sleeps on, and
+ *   sleeps and is woken only through the clock.
+ * - SteadyClock follows std::chrono::steady_clock. VirtualClock moves only
+ *   when all its participants sleep, straight to the earliest deadline.
+ *
+ * @note
+ * - All public functions are thread-safe.
+ */
+class Clock {
+public:
+  /**
+   * @brief Type aliases.
+   */
+  using Duration = std::chrono::steady_clock::duration;
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  /**
+   * @brief Virtual destructor.
+   */
+  virtual ~Clock() = default;
+
+  /**
+   * @brief Returns the current time.
+   */
+  virtual TimePoint now() const = 0;
+
+  /**
+   * @brief Adds a participant.
+   *
+   * @param cv Condition variable the participant sleeps on.
+   */
+  virtual void attach(std::condition_variable &cv) = 0;
+
+  /**
+   * @brief Removes a participant.
+   *
+   * @param cv Condition variable the participant sleeps on.
+   */
+  virtual void detach(std::condition_variable &cv) = 0;
+
+  /**
+   * @brief Sleeps until woken or until a deadline.
+   *
+   * @details
+   * - May return early. The caller checks its condition again.
+   *
+   * @param lock Lock protecting the condition of the participant. Held on
+   *        entry and on return.
+   * @param cv Condition variable of the participant.
+   * @param due Deadline. Nothing to sleep until woken.
+   */
+  virtual void sleep(std::unique_lock<std::mutex> &lock,
+                     std::condition_variable &cv,
+                     std::optional<TimePoint> due) = 0;
+
+  /**
+   * @brief Wakes a participant. Called after its condition changed, without
+   *        its lock.
+   *
+   * @param cv Condition variable of the participant.
+   */
+  virtual void wake(std::condition_variable &cv) = 0;
+}; // class Clock
+
+/**
+ * @class core::SteadyClock
+ *
+ * @brief Clock following std::chrono::steady_clock.
+ */
+class SteadyClock final : public Clock {
+public:
+  TimePoint now() const override { return std::chrono::steady_clock::now(); }
+  void attach(std::condition_variable &) override {}
+  void detach(std::condition_variable &) override {}
+  void sleep(std::unique_lock<std::mutex> &lock, std::condition_variable &cv,
+             std::optional<TimePoint> due) override;
+  void wake(std::condition_variable &cv) override { cv.notify_one(); }
+}; // class SteadyClock
+
+/**
+ * @class core::VirtualClock
+ *
+ * @brief Clock that jumps to the next deadline once all its participants
+ *        are idle.
+ *
+ * @details
+ * - Time stands still while a participant is busy. A simulated hour of
+ *   timers runs as fast as the events can be handled, and in the same order
+ *   on every run.
+ * - A participant is busy from the moment it is woken until it sleeps again,
+ *   so an event posted to an idle loop holds the clock before the loop
+ *   thread even runs.
+ *
+ * @note
+ * - A participant shall block only in sleep(). Blocking elsewhere, e.g. on a
+ *   result of another participant, holds the clock forever.
+ * - Threads that are not participants don't hold the clock, so it may jump
+ *   between two of their posts. A simulation is best set up from an event
+ *   of one of the loops.
+ */
+class VirtualClock final : public Clock {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param start Initial time.
+   */
+  explicit VirtualClock(TimePoint start = TimePoint{}) : now_{start} {}
+
+  TimePoint now() const override;
+  void attach(std::condition_variable &cv) override;
+  void detach(std::condition_variable &cv) override;
+  void sleep(std::unique_lock<std::mutex> &lock, std::condition_variable &cv,
+             std::optional<TimePoint> due) override;
+  void wake(std::condition_variable &cv) override;
+
+private:
+  /**
+   * @brief State of a participant.
+   */
+  struct Participant {
+    bool idle{false};
+    bool woken{false}; // Woken before it went to sleep
+    std::optional<TimePoint> due;
+  }; // struct Participant
+
+  /**
+   * @brief Protects the class.
+   */
+  mutable std::mutex mtx_;
+
+  /**
+   * @brief Wakes the sleeping participants.
+   */
+  std::condition_variable cv_;
+
+  /**
+   * @brief Current time.
+   */
+  TimePoint now_;
+
+  /**
+   * @brief Participants by their condition variable.
+   */
+  std::unordered_map<const std::condition_variable *, Participant>
+      participants_;
+
+  /**
+   * @brief Jumps to the earliest deadline if all participants are idle.
+   *        Called with the lock held.
+   */
+  void advance();
+}; // class VirtualClock
+
+} // namespace helios::core
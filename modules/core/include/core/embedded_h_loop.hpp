@@ -0,0 +1,60 @@
+#pragma once
+
+#include "h_loop.hpp"
+
+namespace helios::core {
+
+/**
+ * @class core::EmbeddedHLoop
+ *
+ * @brief HLoop without a thread of its own, driven by the main loop of a host
+ *        application.
+ *
+ * @details
+ * - The thread that constructs it is its loop thread. The events of its
+ *   InActiveHObjects run inline there, within runOnce(), runFor() or poll(),
+ *   so posting from that thread needs no handoff to another thread.
+ * - A host with its own wait, e.g. poll() on its sockets or a frame timer,
+ *   adds pollFd() to it with pollTimeout() as the timeout, and calls poll()
+ *   once it returns.
+ * - Posts from other threads wake a blocking runOnce() or runFor() and make
+ *   pollFd() readable.
+ *
+ * @note
+ * - pollFd() needs the Epoll engine, which is the default here.
+ * - runOnce(), runFor() and poll() are called from the host thread only, and
+ *   not from within the events they run.
+ * - Objects on the loop are destroyed on the host thread outside of its
+ *   events, where they run their pending events inline, or on other threads
+ *   while the host keeps driving the loop.
+ */
+class EmbeddedHLoop : public HLoop {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param clock Optional clock of the delayed events. Defaults to a
+   *        SteadyClock.
+   * @param engine How runOnce() and runFor() wait. Epoll lets the loop watch
+   *        file descriptors and provides pollFd().
+   */
+  explicit EmbeddedHLoop(std::shared_ptr<Clock> clock = nullptr,
+                         Engine engine = Engine::Epoll)
+      : HLoop(std::move(clock), engine, Driver::Host) {}
+
+  /**
+   * @brief Returns true, the host runs the loop.
+   */
+  bool hostDriven() const override { return true; }
+
+  /**
+   * @brief Host side of the loop.
+   */
+  using ActiveHObject::poll;
+  using ActiveHObject::pollFd;
+  using ActiveHObject::pollTimeout;
+  using ActiveHObject::runFor;
+  using ActiveHObject::runOnce;
+}; // class EmbeddedHLoop
+
+} // namespace helios::core
@@ -1,12 +1,214 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#include "memory_resource.hpp"
 
 namespace helios::core {
 
 /**
- * @brief Type alias for an event handler function.
+ * @class core::Event
+ *
+ * @brief Type-erased event handler function.
+ *
+ * @details
+ * - Callables of up to INLINE_SIZE bytes are stored inside the event. Larger
+ *   ones are allocated from requestMemoryResource().
+ * - Move-only callables are supported.
+ *
+ * @note
+ * - Not thread-safe.
  */
-using Event = std::function<void()>;
+class Event {
+public:
+  /**
+   * @brief Max size of a callable stored without allocation.
+   */
+  static constexpr std::size_t INLINE_SIZE = 48;
+
+  /**
+   * @brief Constructs an empty event.
+   */
+  Event() noexcept = default;
+  Event(std::nullptr_t) noexcept {}
+
+  /**
+   * @brief Constructs an event from a callable.
+   *
+   * @tparam Fn Type of the callable.
+   * @param fn Callable taking no arguments.
+   */
+  template <
+      typename Fn,
+      typename = std::enable_if_t<
+          !std::is_same_v<std::decay_t<Fn>, Event> &&
+          !std::is_same_v<std::decay_t<Fn>, std::nullptr_t>>>
+  Event(Fn &&fn) {
+    using T = std::decay_t<Fn>;
+    if constexpr (isInline<T>()) {
+      new (storage_) T(std::forward<Fn>(fn));
+    } else {
+      resource_ = requestMemoryResource();
+      void *p = resource_->allocate(sizeof(T), alignof(T));
+      try {
+        heap_ = new (p) T(std::forward<Fn>(fn));
+      } catch (...) {
+        resource_->deallocate(p, sizeof(T), alignof(T));
+        throw;
+      }
+    }
+    ops_ = &OPS<T>;
+  }
+
+  /**
+   * @brief Destructor.
+   */
+  ~Event() { reset(); }
+
+  /**
+   * @brief Move semantics. Delete copy semantics.
+   */
+  Event(Event &&other) noexcept { moveFrom(other); }
+  Event &operator=(Event &&other) noexcept {
+    if (this != &other) {
+      reset();
+      moveFrom(other);
+    }
+    return *this;
+  }
+  Event &operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+  Event(const Event &) = delete;
+  Event &operator=(const Event &) = delete;
+
+  /**
+   * @brief Calls the stored callable.
+   *
+   * @throws std::bad_function_call if the event is empty.
+   */
+  void operator()() {
+    if (!ops_)
+      throw std::bad_function_call();
+    ops_->invoke(target());
+  }
+
+  /**
+   * @brief Returns true if a callable is stored.
+   */
+  explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+  /**
+   * @brief Returns a pointer to the stored callable if it is of type T,
+   *        nullptr otherwise.
+   */
+  template <typename T> T *target() noexcept {
+    if (!ops_ || *ops_->type != typeid(T))
+      return nullptr;
+    return static_cast<T *>(target());
+  }
+
+private:
+  /**
+   * @brief Operations on the stored callable.
+   */
+  struct Ops {
+    void (*invoke)(void *);
+    void (*relocate)(void *dst, void *src);
+    void (*destroy)(void *);
+    const std::type_info *type;
+    std::size_t size;
+    std::size_t alignment;
+  }; // struct Ops
+
+  /**
+   * @brief Returns true if T is stored inside the event.
+   */
+  template <typename T> static constexpr bool isInline() {
+    return sizeof(T) <= INLINE_SIZE &&
+           alignof(T) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible_v<T>;
+  }
+
+  /**
+   * @brief Operations for callables of type T.
+   */
+  template <typename T>
+  static constexpr Ops OPS{
+      [](void *fn) { (*static_cast<T *>(fn))(); },
+      [](void *dst, void *src) {
+        new (dst) T(std::move(*static_cast<T *>(src)));
+        static_cast<T *>(src)->~T();
+      },
+      [](void *fn) { static_cast<T *>(fn)->~T(); },
+      &typeid(T),
+      sizeof(T),
+      alignof(T)
+  };
+
+  /**
+   * @brief Storage of inline callables.
+   */
+  alignas(std::max_align_t) std::byte storage_[INLINE_SIZE];
+
+  /**
+   * @brief Allocated callable. nullptr if stored inline.
+   */
+  void *heap_{nullptr};
+
+  /**
+   * @brief Memory resource of the allocated callable.
+   */
+  std::pmr::memory_resource *resource_{nullptr};
+
+  /**
+   * @brief Operations of the stored callable. nullptr if empty.
+   */
+  const Ops *ops_{nullptr};
+
+  /**
+   * @brief Returns a pointer to the stored callable.
+   */
+  void *target() noexcept { return heap_ ? heap_ : storage_; }
+
+  /**
+   * @brief Destroys the stored callable and releases its memory.
+   */
+  void reset() noexcept {
+    if (!ops_)
+      return;
+    ops_->destroy(target());
+    if (heap_)
+      resource_->deallocate(heap_, ops_->size, ops_->alignment);
+    heap_ = nullptr;
+    resource_ = nullptr;
+    ops_ = nullptr;
+  }
+
+  /**
+   * @brief Takes the callable of another event, leaving it empty.
+   */
+  void moveFrom(Event &other) noexcept {
+    if (!other.ops_)
+      return;
+    if (other.heap_) {
+      heap_ = other.heap_;
+      resource_ = other.resource_;
+    } else {
+      other.ops_->relocate(storage_, other.storage_);
+    }
+    ops_ = other.ops_;
+    other.heap_ = nullptr;
+    other.resource_ = nullptr;
+    other.ops_ = nullptr;
+  }
+}; // class Event
 
 } // namespace helios::core
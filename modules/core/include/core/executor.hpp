@@ -0,0 +1,75 @@
+#pragma once
+
+#include "event.hpp"
+
+namespace helios::core {
+
+template <typename ResultType> class FutureResult;
+
+/**
+ * @class core::Executor
+ *
+ * @brief Runs the continuations of FutureResult.
+ *
+ * @details
+ * - Implemented by ActiveHObject, InActiveHObject and InlineExecutor.
+ * - Only FutureResult can hand events to an executor, so deriving from this
+ *   class does not expose post() publicly.
+ *
+ * @note
+ * - All public functions are thread-safe.
+ */
+class Executor {
+public:
+  /**
+   * @brief Virtual destructor.
+   */
+  virtual ~Executor() = default;
+
+  /**
+   * @brief Returns true if the calling thread is the one running the events.
+   */
+  virtual bool runsInCurrentThread() const = 0;
+
+protected:
+  /**
+   * @brief Queues an event to be run by the executor.
+   *
+   * @param e Event to be executed.
+   */
+  virtual void execute(Event e) = 0;
+
+private:
+  template <typename ResultType> friend class FutureResult;
+}; // class Executor
+
+/**
+ * @class core::InlineExecutor
+ *
+ * @brief Runs events directly in the calling thread.
+ */
+class InlineExecutor final : public Executor {
+public:
+  /**
+   * @brief Returns the shared instance.
+   */
+  static InlineExecutor &instance() {
+    static InlineExecutor executor;
+    return executor;
+  }
+
+  /**
+   * @brief Always true since events run in the calling thread.
+   */
+  bool runsInCurrentThread() const override { return true; }
+
+private:
+  /**
+   * @brief Runs the event directly.
+   *
+   * @param e Event to be executed.
+   */
+  void execute(Event e) override { e(); }
+}; // class InlineExecutor
+
+} // namespace helios::core
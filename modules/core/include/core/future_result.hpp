@@ -1,23 +1,29 @@
 #pragma once
 
 #include <chrono>
+#include <exception>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <type_traits>
+#include <variant>
+
+#include "executor.hpp"
+#include "memory_resource.hpp"
 
 namespace helios::core {
 
-#define THEN_POST(block)                                                       \
-  ->then([this](auto &&__value) {                                              \
-    this->post(                                                                \
-        [result = std::forward<decltype(__value)>(__value), this] { block });  \
-  })
+#define THEN_POST(block) ->then(*this, [this](auto result) block)
 
 #define THEN_POST_CALLABLE(fn)                                                 \
-  ->then([this, fn = fn](auto &&__value) {                                     \
-    this->post([result = std::forward<decltype(__value)>(__value),             \
-                fn]() mutable { fn(result); });                                \
-  })
+  ->then(*this, [fn = fn](auto result) mutable { fn(result); })
+
+#define CATCH_POST(block)                                                      \
+  ->onError(*this, [this](std::exception_ptr error) block)
+
+#define CATCH_POST_CALLABLE(fn)                                                \
+  ->onError(*this, [fn = fn](std::exception_ptr error) mutable { fn(error); })
 
 /**
  * @class core::FutureResult
@@ -26,6 +32,16 @@ namespace helios::core {
  *
  * @details
  * - Created to be shared between the producer and the consumer threads.
+ * - The producer either sets a result or an exception. Both wake all waiters
+ *   immediately.
+ * - Only the first result or exception is kept, later ones are ignored.
+ * - Callbacks are handed to an executor. If the producer already runs in the
+ *   thread of that executor, the callback is called directly.
+ * - The result is stored once and shared, never copied, between the producer,
+ *   the callbacks and getPtr(). Move-only results are retrieved with take().
+ * - FutureResult<void> only signals completion. Its value is std::monostate.
+ * - The object, its state and its result are allocated from
+ *   requestMemoryResource() when created with create().
  *
  * @note
  * - All public functions are synchronous.
@@ -38,11 +54,25 @@ public:
    */
   using Ptr = std::shared_ptr<FutureResult<ResultType>>;
 
+  /**
+   * @brief Type of the stored value. std::monostate for FutureResult<void>.
+   */
+  using ValueType = std::conditional_t<
+      std::is_void_v<ResultType>, std::monostate, ResultType>;
+
   /**
    * @brief Default constructor.
    */
   FutureResult();
 
+  /**
+   * @brief Creates a shared FutureResult allocated from
+   *        requestMemoryResource().
+   */
+  static Ptr create() {
+    return std::allocate_shared<FutureResult>(RequestAllocator<FutureResult>());
+  }
+
   /**
    * @brief Default destructor.
    */
@@ -51,19 +81,89 @@ public:
   /**
    * @brief Sets the result.
    *
-   * @tparam value Value of the result.
+   * @tparam Args Types of the arguments used to construct the result.
+   * @param args Arguments used to construct the result in place. Empty for
+   *        FutureResult<void>.
    */
-  template <typename T> void set(T &&value) {
-    auto r = std::make_shared<ResultType>(std::forward<T>(value));
+  template <typename... Args> void set(Args &&...args) {
+    auto r = std::allocate_shared<ValueType>(
+        RequestAllocator<ValueType>(), std::forward<Args>(args)...
+    );
     setImpl(std::move(r));
   }
 
+  /**
+   * @brief Sets an exception instead of the result.
+   *
+   * @param e Exception that caused the operation to fail.
+   */
+  void setException(std::exception_ptr e);
+
   /**
    * @brief Sets the callback to be called when the result is available.
    *
    * @param cb Client's callback.
+   *
+   * @return Pointer to this object to chain onError().
+   *
+   * @note
+   * - The callback is called in the thread that sets the result.
+   * - The callback is not called if an exception is set.
    */
-  void then(std::function<void(std::shared_ptr<ResultType>)> cb);
+  FutureResult *then(std::function<void(std::shared_ptr<ResultType>)> cb) {
+    return then(InlineExecutor::instance(), std::move(cb));
+  }
+
+  /**
+   * @brief Sets the callback to be run by an executor when the result is
+   *        available.
+   *
+   * @tparam Fn Type of the callback. Called with std::shared_ptr<ResultType>.
+   * @param executor Executor that runs the callback. Must outlive the result.
+   * @param fn Client's callback.
+   *
+   * @return Pointer to this object to chain onError().
+   *
+   * @note
+   * - The callback is not called if an exception is set.
+   */
+  template <typename Fn> FutureResult *then(Executor &executor, Fn &&fn) {
+    thenImpl(makeContinuation<std::shared_ptr<ResultType>>(
+        executor, std::forward<Fn>(fn)
+    ));
+    return this;
+  }
+
+  /**
+   * @brief Sets the callback to be called when an exception is set.
+   *
+   * @param cb Client's callback.
+   *
+   * @return Pointer to this object to chain then().
+   *
+   * @note
+   * - The callback is called in the thread that sets the exception.
+   */
+  FutureResult *onError(std::function<void(std::exception_ptr)> cb) {
+    return onError(InlineExecutor::instance(), std::move(cb));
+  }
+
+  /**
+   * @brief Sets the callback to be run by an executor when an exception is
+   *        set.
+   *
+   * @tparam Fn Type of the callback. Called with std::exception_ptr.
+   * @param executor Executor that runs the callback. Must outlive the result.
+   * @param fn Client's callback.
+   *
+   * @return Pointer to this object to chain then().
+   */
+  template <typename Fn> FutureResult *onError(Executor &executor, Fn &&fn) {
+    onErrorImpl(makeContinuation<std::exception_ptr>(
+        executor, std::forward<Fn>(fn)
+    ));
+    return this;
+  }
 
   /**
    * @brief Returns a shared pointer to the result.
@@ -72,6 +172,8 @@ public:
    *
    * @return Result value. nullptr if timeout is triggered.
    *
+   * @throws The exception set by setException().
+   *
    * @note
    * - If the timeout argument is empty, then the function will block for the
    *   max possible timeout.
@@ -87,13 +189,33 @@ public:
    * @return Result value as optional. The optional will be invalid in case the
    *         timeout is triggered.
    *
+   * @throws The exception set by setException().
+   *
    * @note
    * - If the timeout argument is empty, then the function will block for the
    *   max possible timeout.
    */
-  std::optional<ResultType>
+  std::optional<ValueType>
   get(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
 
+  /**
+   * @brief Moves the result out.
+   *
+   * @param timeout The max timeout to block for the result.
+   *
+   * @return Result value as optional. The optional will be invalid in case the
+   *         timeout is triggered.
+   *
+   * @throws The exception set by setException().
+   *
+   * @note
+   * - Works with move-only results and avoids copying large ones.
+   * - The stored result is left in a moved-from state, so only one consumer
+   *   shall take it.
+   */
+  std::optional<ValueType>
+  take(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
   /**
    * @brief Delete copy and move semantics.
    */
@@ -103,15 +225,45 @@ public:
   FutureResult &operator=(FutureResult &&) = delete;
 
 private:
+  /**
+   * @brief Callback waiting for its argument to be handed to its executor.
+   *
+   * @tparam ArgT Type of the argument passed to the callback.
+   */
+  template <typename ArgT> struct Continuation {
+    /**
+     * @brief Callback together with a slot for its argument.
+     */
+    Event event;
+
+    /**
+     * @brief Executor that runs the event.
+     */
+    Executor *executor{nullptr};
+
+    /**
+     * @brief Stores the argument inside the event.
+     */
+    void (*bind)(Event &, ArgT){nullptr};
+  }; // struct Continuation
+
   /**
    * @brief Forward declaration for the implementation class.
    */
   class Impl;
 
+  /**
+   * @brief Destroys the implementation class and returns its memory to the
+   *        resource it came from.
+   */
+  struct ImplDeleter {
+    void operator()(Impl *impl) const;
+  }; // struct ImplDeleter
+
   /**
    * @brief Unique pointer to the implementation class.
    */
-  std::unique_ptr<Impl> impl_;
+  std::unique_ptr<Impl, ImplDeleter> impl_;
 
   /**
    * @brief Sets the result.
@@ -119,6 +271,54 @@ private:
    * @param value Value of the result.
    */
   void setImpl(std::shared_ptr<void> value);
+
+  /**
+   * @brief Stores or dispatches the result continuation.
+   *
+   * @param c Continuation of then().
+   */
+  void thenImpl(Continuation<std::shared_ptr<ResultType>> c);
+
+  /**
+   * @brief Stores or dispatches the exception continuation.
+   *
+   * @param c Continuation of onError().
+   */
+  void onErrorImpl(Continuation<std::exception_ptr> c);
+
+  /**
+   * @brief Blocks until a result or an exception is set or the timeout is
+   *        triggered.
+   *
+   * @param lock Lock held on the implementation's mutex.
+   * @param timeout The max timeout to block for the result.
+   *
+   * @throws The exception set by setException().
+   */
+  void wait(std::unique_lock<std::mutex> &lock,
+            std::chrono::milliseconds timeout);
+
+  /**
+   * @brief Wraps a callback into a continuation.
+   *
+   * @tparam ArgT Type of the argument passed to the callback.
+   * @tparam Fn Type of the callback.
+   * @param executor Executor that runs the callback.
+   * @param fn Callback.
+   */
+  template <typename ArgT, typename Fn>
+  static Continuation<ArgT> makeContinuation(Executor &executor, Fn &&fn);
+
+  /**
+   * @brief Hands a continuation to its executor or runs it directly if the
+   *        calling thread is the executor's thread.
+   *
+   * @tparam ArgT Type of the argument passed to the callback.
+   * @param c Continuation.
+   * @param arg Argument passed to the callback.
+   */
+  template <typename ArgT>
+  static void dispatch(Continuation<ArgT> c, ArgT arg);
 }; // class FutureResult
 
 } // namespace helios::core
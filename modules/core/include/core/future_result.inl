@@ -2,16 +2,34 @@
 
 #include <condition_variable>
 #include <mutex>
+#include <type_traits>
 
 namespace helios::core {
 
 template <typename ResultType> class FutureResult<ResultType>::Impl {
 public:
+  /**
+   * @brief Constructor.
+   *
+   * @param resource Memory resource this object is allocated from.
+   */
+  explicit Impl(std::pmr::memory_resource *resource) : resource_(resource) {}
+
+  /**
+   * @brief Memory resource this object is allocated from.
+   */
+  std::pmr::memory_resource *resource_;
+
   /**
    * @brief Value of the result.
    */
   std::shared_ptr<void> result_;
 
+  /**
+   * @brief Exception set instead of the result.
+   */
+  std::exception_ptr error_;
+
   /**
    * @brief Protects this class.
    */
@@ -25,70 +43,181 @@ public:
   /**
    * @brief Callback to receive the result asynchronously.
    */
-  std::function<void(std::shared_ptr<ResultType>)> cb_;
+  Continuation<std::shared_ptr<ResultType>> cb_;
+
+  /**
+   * @brief Callback to receive the exception asynchronously.
+   */
+  Continuation<std::exception_ptr> errCb_;
+
+  /**
+   * @brief Returns true if a result or an exception is set.
+   */
+  bool isReady() const { return result_ != nullptr || error_ != nullptr; }
 }; // class FutureResult<ResultType>::Impl
 
 template <typename ResultType>
-FutureResult<ResultType>::FutureResult() : impl_(std::make_unique<Impl>()) {}
+FutureResult<ResultType>::FutureResult() {
+  RequestAllocator<Impl> alloc;
+  Impl *impl = alloc.allocate(1);
+  try {
+    impl_.reset(new (impl) Impl(alloc.resource()));
+  } catch (...) {
+    alloc.deallocate(impl, 1);
+    throw;
+  }
+}
+
+template <typename ResultType>
+void FutureResult<ResultType>::ImplDeleter::operator()(Impl *impl) const {
+  std::pmr::memory_resource *resource = impl->resource_;
+  impl->~Impl();
+  resource->deallocate(impl, sizeof(Impl), alignof(Impl));
+}
 
 template <typename ResultType>
 FutureResult<ResultType>::~FutureResult() = default;
 
 template <typename ResultType>
 void FutureResult<ResultType>::setImpl(std::shared_ptr<void> value) {
-  std::function<void(std::shared_ptr<ResultType>)> copy;
+  Continuation<std::shared_ptr<ResultType>> cb;
   {
     std::lock_guard<std::mutex> lock(impl_->mtx_);
+    if (impl_->isReady())
+      return;
     impl_->result_ = value; // Store the result
-    copy = impl_->cb_;
+    cb = std::move(impl_->cb_);
+    impl_->errCb_ = {};
+  }
+
+  impl_->cv_.notify_all(); // Notify other threads that the result is ready
+
+  if (cb.event)
+    // Hand the client's callback the new result
+    dispatch(std::move(cb), std::static_pointer_cast<ResultType>(value));
+}
+
+template <typename ResultType>
+void FutureResult<ResultType>::setException(std::exception_ptr e) {
+  Continuation<std::exception_ptr> cb;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mtx_);
+    if (impl_->isReady())
+      return;
+    impl_->error_ = e; // Store the exception
+    cb = std::move(impl_->errCb_);
+    impl_->cb_ = {};
   }
 
-  impl_->cv_.notify_one(); // Notify other threads that the result is ready
+  impl_->cv_.notify_all(); // Wake the waiters instead of letting them time out
 
-  if (copy)
-    // Call the client's callback with the new result
-    copy(std::static_pointer_cast<ResultType>(value));
+  if (cb.event)
+    // Hand the client's error callback the exception
+    dispatch(std::move(cb), std::move(e));
 }
 
 template <typename ResultType>
-void FutureResult<ResultType>::then(
-    std::function<void(std::shared_ptr<ResultType>)> cb) {
+void FutureResult<ResultType>::thenImpl(
+    Continuation<std::shared_ptr<ResultType>> c
+) {
   {
     std::lock_guard<std::mutex> lock(impl_->mtx_);
 
+    if (impl_->error_)
+      return;
+
     if (!impl_->result_) {
-      impl_->cb_ = std::move(cb);
+      impl_->cb_ = std::move(c);
       return;
     }
   }
-  cb(std::static_pointer_cast<ResultType>(impl_->result_));
+  dispatch(std::move(c), std::static_pointer_cast<ResultType>(impl_->result_));
 }
 
 template <typename ResultType>
-std::shared_ptr<ResultType>
-FutureResult<ResultType>::getPtr(std::chrono::milliseconds timeout) {
-  std::unique_lock<std::mutex> lock(impl_->mtx_);
+void FutureResult<ResultType>::onErrorImpl(Continuation<std::exception_ptr> c) {
+  {
+    std::lock_guard<std::mutex> lock(impl_->mtx_);
+
+    if (impl_->result_)
+      return;
+
+    if (!impl_->error_) {
+      impl_->errCb_ = std::move(c);
+      return;
+    }
+  }
+  dispatch(std::move(c), impl_->error_);
+}
+
+template <typename ResultType>
+template <typename ArgT, typename Fn>
+typename FutureResult<ResultType>::template Continuation<ArgT>
+FutureResult<ResultType>::makeContinuation(Executor &executor, Fn &&fn) {
+  // The argument lives next to the callback inside one event, so handing the
+  // continuation to its executor does not allocate again.
+  struct Call {
+    std::decay_t<Fn> fn;
+    ArgT arg;
+    void operator()() { fn(std::move(arg)); }
+  };
+
+  Continuation<ArgT> c;
+  c.event = Call{std::forward<Fn>(fn), ArgT{}};
+  c.executor = &executor;
+  c.bind = [](Event &e, ArgT arg) { e.target<Call>()->arg = std::move(arg); };
+  return c;
+}
+
+template <typename ResultType>
+template <typename ArgT>
+void FutureResult<ResultType>::dispatch(Continuation<ArgT> c, ArgT arg) {
+  c.bind(c.event, std::move(arg));
+  if (c.executor->runsInCurrentThread())
+    c.event(); // Already in the executor's thread
+  else
+    c.executor->execute(std::move(c.event));
+}
+
+template <typename ResultType>
+void FutureResult<ResultType>::wait(std::unique_lock<std::mutex> &lock,
+                                    std::chrono::milliseconds timeout) {
   if (timeout == std::chrono::milliseconds::max()) {
-    impl_->cv_.wait(lock, [this] { return impl_->result_ != nullptr; });
+    impl_->cv_.wait(lock, [this] { return impl_->isReady(); });
   } else {
-    impl_->cv_.wait_for(lock, timeout,
-                        [this] { return impl_->result_ != nullptr; });
+    impl_->cv_.wait_for(lock, timeout, [this] { return impl_->isReady(); });
   }
+  if (impl_->error_)
+    std::rethrow_exception(impl_->error_);
+}
+
+template <typename ResultType>
+std::shared_ptr<ResultType>
+FutureResult<ResultType>::getPtr(std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(impl_->mtx_);
+  wait(lock, timeout);
   return std::static_pointer_cast<ResultType>(impl_->result_);
 }
 
 template <typename ResultType>
-std::optional<ResultType>
+std::optional<typename FutureResult<ResultType>::ValueType>
 FutureResult<ResultType>::get(std::chrono::milliseconds timeout) {
   std::unique_lock<std::mutex> lock(impl_->mtx_);
-  std::optional<ResultType> res;
-  if (timeout == std::chrono::milliseconds::max()) {
-    impl_->cv_.wait(lock, [this] { return impl_->result_ != nullptr; });
-    res = *std::static_pointer_cast<ResultType>(impl_->result_);
-  } else {
-    impl_->cv_.wait_for(lock, timeout,
-                        [this] { return impl_->result_ != nullptr; });
-  }
+  std::optional<ValueType> res;
+  wait(lock, timeout);
+  if (impl_->result_)
+    res = *std::static_pointer_cast<ValueType>(impl_->result_);
+  return res;
+}
+
+template <typename ResultType>
+std::optional<typename FutureResult<ResultType>::ValueType>
+FutureResult<ResultType>::take(std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(impl_->mtx_);
+  std::optional<ValueType> res;
+  wait(lock, timeout);
+  if (impl_->result_)
+    res = std::move(*std::static_pointer_cast<ValueType>(impl_->result_));
   return res;
 }
 
@@ -6,6 +6,31 @@ namespace helios::core {
 
 class HLoop : public ActiveHObject {
 public:
+  /**
+   * @brief Constructor.
+   *
+   * @param clock Optional clock of the delayed events. Defaults to a
+   *        SteadyClock.
+   * @param engine How the loop thread sleeps. Epoll lets the loop watch file
+   *        descriptors.
+   */
+  explicit HLoop(std::shared_ptr<Clock> clock = nullptr,
+                 Engine engine = Engine::CondVar)
+      : ActiveHObject(nullptr, std::move(clock), engine) {}
+
+  /**
+   * @brief Returns true if a host runs the loop from its own thread instead
+   *        of a loop thread.
+   */
+  virtual bool hostDriven() const { return false; }
+
+  /**
+   * @brief File descriptor watching of the Epoll engine.
+   */
+  using ActiveHObject::modify;
+  using ActiveHObject::unwatch;
+  using ActiveHObject::watch;
+
   /**
    * @brief Posts an event to the queue.
    *
@@ -15,6 +40,66 @@ public:
   template <typename EventT> void post(EventT &&e) {
     ActiveHObject::post(std::forward<EventT>(e));
   }
+
+  /**
+   * @brief Posts an event that runs once a delay has passed.
+   *
+   * @tparam EventT Type of event to be posted.
+   * @param delay Delay from now.
+   * @param e Event to be posted.
+   */
+  template <typename EventT> void postAfter(Clock::Duration delay, EventT &&e) {
+    ActiveHObject::postAfter(delay, std::forward<EventT>(e));
+  }
+
+  /**
+   * @brief Posts an event that runs once a time point is reached.
+   *
+   * @tparam EventT Type of event to be posted.
+   * @param due Time point when the event runs.
+   * @param e Event to be posted.
+   */
+  template <typename EventT> void postAt(Clock::TimePoint due, EventT &&e) {
+    ActiveHObject::postAt(due, std::forward<EventT>(e));
+  }
+
+  /**
+   * @brief Posts an event that runs once a time point is reached, on behalf
+   *        of an owner that can erase it with eraseTimers().
+   *
+   * @tparam EventT Type of event to be posted.
+   * @param due Time point when the event runs.
+   * @param owner Key of the owner.
+   * @param e Event to be posted.
+   */
+  template <typename EventT>
+  void postAt(Clock::TimePoint due, const void *owner, EventT &&e) {
+    ActiveHObject::postAt(due, owner, std::forward<EventT>(e));
+  }
+
+  /**
+   * @brief Erases the pending delayed events of an owner.
+   */
+  using ActiveHObject::eraseTimers;
+
+protected:
+  /**
+   * @brief Constructor.
+   *
+   * @param clock Optional clock of the delayed events. Defaults to a
+   *        SteadyClock.
+   * @param engine How the loop sleeps.
+   * @param driver Who runs the event queue.
+   */
+  HLoop(std::shared_ptr<Clock> clock, Engine engine, Driver driver)
+      : ActiveHObject(nullptr, std::move(clock), engine, driver) {}
+
+private:
+  /**
+   * @brief Runs the loop with poll() while it waits for it on the host
+   *        thread.
+   */
+  friend class InActiveHObject;
 }; // class HLoop
 
 } // namespace helios::core
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
 #include "event.hpp"
+#include "executor.hpp"
 #include "future_result.hpp"
 #include "h_loop.hpp"
 #include "h_object.hpp"
@@ -14,11 +19,14 @@ namespace helios::core {
  *
  * @details
  * - Adds asynchronous capability but needs core::HLoop to run it.
+ * - Acts as an executor that forwards FutureResult continuations to the loop.
+ * - Delayed events are kept by the loop. Those not due when the object is
+ *   destroyed never run.
  *
  * @note
  * - post() is thread-safe.
  */
-class InActiveHObject : public HObject {
+class InActiveHObject : public HObject, public Executor {
 public:
   /**
    * @brief Constructor.
@@ -42,6 +50,11 @@ public:
   InActiveHObject(InActiveHObject &&) = delete;
   InActiveHObject &operator=(InActiveHObject &&) = delete;
 
+  /**
+   * @brief Returns true if called from the thread of the loop.
+   */
+  bool runsInCurrentThread() const override;
+
 protected:
   /**
    * @brief Posts an event to the queue.
@@ -53,18 +66,153 @@ protected:
     postImpl(std::forward<EventT>(e));
   }
 
+  /**
+   * @brief Posts an event that runs on the loop once a delay has passed.
+   *
+   * @tparam EventT Type of event to be posted.
+   * @param delay Delay from now.
+   * @param e Event to be posted.
+   */
+  template <typename EventT>
+  void postAfter(Clock::Duration delay, EventT &&e) {
+    postAtImpl(loop_->clock().now() + delay, std::forward<EventT>(e));
+  }
+
+  /**
+   * @brief Posts an event that runs on the loop once a time point is reached.
+   *
+   * @tparam EventT Type of event to be posted.
+   * @param due Time point when the event runs.
+   * @param e Event to be posted.
+   */
+  template <typename EventT>
+  void postAt(Clock::TimePoint due, EventT &&e) {
+    postAtImpl(due, std::forward<EventT>(e));
+  }
+
+  /**
+   * @brief Runs an event directly if called from the thread of the loop,
+   *        otherwise posts it to the loop.
+   *
+   * @tparam EventT Type of event to be dispatched.
+   * @param e Event to be dispatched.
+   *
+   * @note
+   * - A directly run event overtakes the events already in the queue.
+   */
+  template <typename EventT> void dispatch(EventT &&e) {
+    if (runsInCurrentThread())
+      e();
+    else
+      postImpl(std::forward<EventT>(e));
+  }
+
+  /**
+   * @brief Starts watching a file descriptor on the loop.
+   *
+   * @details
+   * - Only loops of the Epoll engine watch file descriptors.
+   * - The object unwatches its descriptors before it is destroyed.
+   *
+   * @param fd File descriptor.
+   * @param events Epoll events to watch, e.g. EPOLLIN.
+   * @param cb Callback run on the loop thread when the descriptor is ready.
+   *
+   * @return False if the loop can't watch the descriptor.
+   */
+  bool watch(int fd, std::uint32_t events, HLoop::IoCallback cb) {
+    return loop_->watch(fd, events, std::move(cb));
+  }
+
+  /**
+   * @brief Changes the events of a watched file descriptor.
+   *
+   * @return False if the descriptor is not watched or epoll refuses it.
+   */
+  bool modify(int fd, std::uint32_t events) {
+    return loop_->modify(fd, events);
+  }
+
+  /**
+   * @brief Stops watching a file descriptor.
+   *
+   * @return False if the descriptor is not watched.
+   */
+  bool unwatch(int fd) { return loop_->unwatch(fd); }
+
+  /**
+   * @brief Blocks until the events posted so far are handled.
+   *
+   * @details
+   * - Derived classes whose events use their own members call it in their
+   *   destructor, since those members are destroyed before this class.
+   *
+   * @note
+   * - Shall not be called from the thread of the loop. On the host thread
+   *   of a host-driven loop, it runs the events itself instead of blocking.
+   */
+  void drain();
+
+  /**
+   * @brief Cancels the delayed events of this object that did not run yet.
+   *
+   * @details
+   * - They are erased from the loop at once, which releases their captures.
+   * - Runs on the loop thread behind the events posted so far, so it waits
+   *   for them like drain(). Called from the thread of the loop, it cancels
+   *   them right away.
+   * - Delayed events posted afterwards run as usual.
+   * - Derived classes whose delayed events use their own members call it in
+   *   their destructor before drain().
+   */
+  void cancelTimers();
+
 private:
   /**
    * @brief Shared pointer to the event loop.
    */
   std::shared_ptr<HLoop> loop_;
 
+  /**
+   * @brief Generation of the delayed events. Bumped by cancelTimers() to
+   *        skip those already taken for the running batch of the loop, which
+   *        may run after this object is destroyed.
+   */
+  std::shared_ptr<std::atomic<std::uint64_t>> timerGen_;
+
   /**
    * @brief Posts an event to the queue.
    *
    * @param e Event to be posted.
    */
   void postImpl(Event e);
-};
+
+  /**
+   * @brief Posts a delayed event to the loop.
+   *
+   * @param due Time point when the event runs.
+   * @param e Event to be posted.
+   */
+  void postAtImpl(Clock::TimePoint due, Event e);
+
+  /**
+   * @brief Posts a marker behind the queued events and blocks until it ran.
+   *
+   * @param cancel Set to true to cancel the delayed events in the marker.
+   */
+  void sync(bool cancel);
+
+  /**
+   * @brief Cancels the delayed events. Called from the thread of the loop.
+   */
+  void dropTimers();
+
+  /**
+   * @brief Posts a FutureResult continuation to the loop.
+   *
+   * @param e Event to be posted.
+   */
+  void execute(Event e) override;
+}; // class InActiveHObject
 
 } // namespace helios::core
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace helios::core {
+
+/**
+ * @brief Returns the memory resource used on the request path.
+ *
+ * @details
+ * - Events, FutureResult objects and their results are allocated from it.
+ * - Defaults to a process-wide std::pmr::synchronized_pool_resource, which
+ *   keeps per-thread free lists so that steady request traffic is served from
+ *   recycled blocks instead of the global allocator.
+ *
+ * @note
+ * - Thread-safe.
+ */
+std::pmr::memory_resource *requestMemoryResource() noexcept;
+
+/**
+ * @brief Replaces the memory resource used on the request path.
+ *
+ * @param resource New memory resource. nullptr restores the default one.
+ *
+ * @return The previous memory resource.
+ *
+ * @note
+ * - Thread-safe.
+ * - Every allocation is returned to the resource it was taken from, so the
+ *   previous resource must outlive the objects allocated from it.
+ */
+std::pmr::memory_resource *
+setRequestMemoryResource(std::pmr::memory_resource *resource) noexcept;
+
+/**
+ * @class core::RequestAllocator
+ *
+ * @brief Allocator that takes its memory from requestMemoryResource().
+ *
+ * @details
+ * - The memory resource is captured on construction, so the memory is always
+ *   returned to the resource it came from.
+ * - Unlike std::pmr::polymorphic_allocator, it does not pass itself to the
+ *   constructed objects, so the objects keep their own allocators.
+ */
+template <typename T> class RequestAllocator {
+public:
+  using value_type = T;
+
+  RequestAllocator() noexcept : resource_(requestMemoryResource()) {}
+
+  template <typename U>
+  RequestAllocator(const RequestAllocator<U> &other) noexcept
+      : resource_(other.resource()) {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(resource_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *p, std::size_t n) noexcept {
+    resource_->deallocate(p, n * sizeof(T), alignof(T));
+  }
+
+  std::pmr::memory_resource *resource() const noexcept { return resource_; }
+
+  template <typename U>
+  bool operator==(const RequestAllocator<U> &other) const noexcept {
+    return resource_ == other.resource();
+  }
+
+  template <typename U>
+  bool operator!=(const RequestAllocator<U> &other) const noexcept {
+    return resource_ != other.resource();
+  }
+
+private:
+  /**
+   * @brief Memory resource the memory is taken from.
+   */
+  std::pmr::memory_resource *resource_;
+}; // class RequestAllocator
+
+} // namespace helios::core
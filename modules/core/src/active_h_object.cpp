@@ -1,13 +1,57 @@
 #include "core/active_h_object.hpp"
 
+#include <algorithm>
+#include <climits>
+#include <cstdio>
 #include <future>
+#include <iterator>
+#include <stdexcept>
+
+#include "reactor.hpp"
+
+namespace {
+
+/**
+ * @brief Orders the heap of the delayed events, earliest on top.
+ */
+constexpr auto later = [](const auto &a, const auto &b) {
+  return a.due != b.due ? a.due > b.due : a.seq > b.seq;
+};
+
+/**
+ * @brief Returns an epoll timeout in milliseconds, rounded up and at least 0.
+ */
+int timeoutMs(helios::core::Clock::Duration left) {
+  const auto ms = std::chrono::ceil<std::chrono::milliseconds>(left).count();
+  return static_cast<int>(std::clamp<decltype(ms)>(ms, 0, INT_MAX));
+}
+
+} // namespace
 
 namespace helios::core {
 
-ActiveHObject::ActiveHObject(std::shared_ptr<HBus> hBus)
-    : HObject(std::move(hBus)) {
+ActiveHObject::ActiveHObject(std::shared_ptr<HBus> hBus,
+                             std::shared_ptr<Clock> clock, Engine engine,
+                             Driver driver)
+    : HObject(std::move(hBus)),
+      clock_(clock ? std::move(clock) : std::make_shared<SteadyClock>()),
+      driver_(driver) {
+  if (engine == Engine::Epoll) {
+    // epoll_wait() sleeps in real time
+    if (dynamic_cast<SteadyClock *>(clock_.get()) == nullptr)
+      throw std::invalid_argument("The Epoll engine needs a SteadyClock");
+    reactor_ = std::make_unique<Reactor>();
+  }
+  clock_->attach(cv_);
+  if (driver_ == Driver::Host) {
+    loopThreadId_ = std::this_thread::get_id();
+    if (reactor_)
+      reactor_->prepareSleep(); // Posts signal pollFd() from now on
+    return;
+  }
   std::promise<void> started;
   auto main = [this, &started] {
+    loopThreadId_ = std::this_thread::get_id();
     started.set_value(); // Indicate that the loop thread started
     run();               // Run event queue
   };
@@ -16,20 +60,78 @@ ActiveHObject::ActiveHObject(std::shared_ptr<HBus> hBus)
 }
 
 ActiveHObject::~ActiveHObject() {
-  // Post a stop event
+  cancelTimers();
+  drain();
+  if (driver_ == Driver::Host) {
+    clock_->detach(cv_);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stopLoop_ = true; // Stop the loop thread
+  }
+
+  wakeLoop(); // Notify loop thread
+  t_.join();  // Wait for loop thread to exit
+  clock_->detach(cv_);
+}
+
+void ActiveHObject::drain() { sync(false); }
+
+void ActiveHObject::cancelTimers() {
+  if (runsInCurrentThread()) {
+    dropTimers(); // Nothing else runs the loop meanwhile
+    return;
+  }
+  sync(true);
+}
+
+void ActiveHObject::sync(bool cancel) {
+  // Post a marker event behind the queued ones
   std::promise<void> finished;
-  postImpl([this, &finished] {
+  postImpl([this, cancel, &finished] {
+    if (cancel)
+      dropTimers();
     finished.set_value(); // Indicate that the event has executed
   });
-  finished.get_future().get(); // Wait for the stop event to be executed
+  auto done = finished.get_future();
+  if (driver_ == Driver::Host && runsInCurrentThread()) {
+    // Nobody else runs the queue
+    while (done.wait_for(std::chrono::seconds(0)) !=
+           std::future_status::ready)
+      poll();
+    return;
+  }
+  done.get(); // Wait for the marker event to be executed
+}
 
+void ActiveHObject::dropTimers() {
+  std::vector<TimedEvent> dropped;
   {
     std::lock_guard<std::mutex> lock(mtx_);
-    stopLoop_ = true; // Stop the loop thread
+    dropped.swap(timers_);
+  }
+  timersCancelled_ = true; // Skip those left in the running batch
+  // The captures are released here, outside of the lock
+}
+
+void ActiveHObject::eraseTimers(const void *owner) {
+  std::vector<TimedEvent> erased;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    const auto first = std::partition(
+        timers_.begin(), timers_.end(),
+        [owner](const TimedEvent &t) { return t.owner != owner; }
+    );
+    if (first == timers_.end())
+      return;
+    erased.assign(std::make_move_iterator(first),
+                  std::make_move_iterator(timers_.end()));
+    timers_.erase(first, timers_.end());
+    std::make_heap(timers_.begin(), timers_.end(), later);
   }
-  
-  cv_.notify_one(); // Notify loop thread
-  t_.join();        // Wait for loop thread to exit
+  // The captures are released here, outside of the lock
 }
 
 void ActiveHObject::postImpl(Event e) {
@@ -37,33 +139,189 @@ void ActiveHObject::postImpl(Event e) {
     std::lock_guard<std::mutex> lock(mtx_);
     q_.emplace_back(std::move(e));
   }
-  cv_.notify_one(); // Notify loop thread
+  wakeLoop(); // Notify loop thread
+}
+
+void ActiveHObject::postAtImpl(Clock::TimePoint due, Event e,
+                               const void *owner) {
+  bool earliest;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    earliest = timers_.empty() || due < timers_.front().due;
+    timers_.push_back(TimedEvent{due, ++timerSeq_, owner, std::move(e)});
+    std::push_heap(timers_.begin(), timers_.end(), later);
+  }
+  if (earliest)
+    wakeLoop(); // Wake the loop thread to shorten its sleep
+}
+
+void ActiveHObject::onError(ErrorHandler handler) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  errorHandler_ = std::move(handler);
+}
+
+void ActiveHObject::report(std::exception_ptr error) {
+  ErrorHandler handler;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    handler = errorHandler_;
+  }
+  if (handler) {
+    handler(error);
+    return;
+  }
+  // The core can't use the logger, which is built on top of it
+  try {
+    std::rethrow_exception(error);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "helios: Event failed: %s\n", e.what());
+  } catch (...) {
+    std::fprintf(stderr, "helios: Event failed with an unknown exception\n");
+  }
+}
+
+bool ActiveHObject::runsInCurrentThread() const {
+  return std::this_thread::get_id() == loopThreadId_;
+}
+
+void ActiveHObject::execute(Event e) { postImpl(std::move(e)); }
+
+bool ActiveHObject::watch(int fd, std::uint32_t events, IoCallback cb) {
+  return reactor_ && reactor_->watch(fd, events, std::move(cb));
+}
+
+bool ActiveHObject::modify(int fd, std::uint32_t events) {
+  return reactor_ && reactor_->modify(fd, events);
+}
+
+bool ActiveHObject::unwatch(int fd) {
+  return reactor_ && reactor_->unwatch(fd);
+}
+
+void ActiveHObject::wakeLoop() {
+  if (reactor_)
+    reactor_->wake();
+  else
+    clock_->wake(cv_);
+}
+
+void ActiveHObject::sleepLoop(std::unique_lock<std::mutex> &lock,
+                              std::optional<Clock::TimePoint> due) {
+  if (!reactor_) {
+    clock_->sleep(lock, cv_, due);
+    return;
+  }
+  // Rounded up, the loop checks the deadline again anyway
+  const int timeout = due ? timeoutMs(*due - clock_->now()) : -1;
+  reactor_->prepareSleep();
+  lock.unlock();
+  reactor_->wait(timeout, ready_);
+  lock.lock();
 }
 
 void ActiveHObject::run() {
-  while (true) {
-    std::deque<Event> snapshot;
-    {
-      std::unique_lock<std::mutex> lock(mtx_);
+  while (runEvents(std::nullopt, true).has_value()) {
+  }
+}
 
-      // Sleep until the thread is stopped or an event is added to the queue
-      cv_.wait(lock, [this] { return stopLoop_ || !q_.empty(); });
+std::size_t ActiveHObject::runOnce() {
+  return runEvents(std::nullopt, true).value_or(0);
+}
+
+std::size_t ActiveHObject::runFor(Clock::Duration duration) {
+  const auto until = clock_->now() + duration;
+  std::size_t handled{0};
+  do {
+    handled += runEvents(until, true).value_or(0);
+  } while (clock_->now() < until);
+  return handled;
+}
+
+std::size_t ActiveHObject::poll() {
+  return runEvents(std::nullopt, false).value_or(0);
+}
+
+int ActiveHObject::pollFd() const { return reactor_ ? reactor_->fd() : -1; }
+
+int ActiveHObject::pollTimeout() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (!q_.empty() || !ready_.empty())
+    return 0;
+  if (timers_.empty())
+    return -1;
+  return timeoutMs(timers_.front().due - clock_->now());
+}
+
+std::optional<std::size_t>
+ActiveHObject::runEvents(std::optional<Clock::TimePoint> until, bool wait) {
+  if (!wait && reactor_)
+    reactor_->wait(0, ready_); // Collect the ready descriptors
+  std::size_t firstTimer;
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
 
-      if (stopLoop_)
+    // Sleep until the thread is stopped, an event is added to the queue, the
+    // next delayed event is due or the time to wait is over
+    bool slept{false};
+    while (wait && !stopLoop_ && q_.empty() && ready_.empty()) {
+      const auto now = clock_->now();
+      if (until && *until <= now)
         break;
-      snapshot.swap(q_); // Take a snapshot of the queue
-    }
-    // Handle events in the snapshot
-    for (const auto &event : snapshot) {
-      try {
-        event(); // Handle event
-      } catch (const std::exception &e) {
-        // TODO: Log
-      } catch (...) {
-        // TODO: Log
+      std::optional<Clock::TimePoint> due = until;
+      if (!timers_.empty()) {
+        if (timers_.front().due <= now)
+          break;
+        if (!due || timers_.front().due < *due)
+          due = timers_.front().due;
       }
+      sleepLoop(lock, due);
+      slept = true;
+    }
+
+    if (stopLoop_)
+      return std::nullopt;
+    if (wait && reactor_ && !slept) {
+      // A busy loop never sleeps in epoll_wait(), so collect the ready
+      // descriptors here to keep them from starving
+      lock.unlock();
+      reactor_->wait(0, ready_);
+      lock.lock();
+    }
+    snapshot_.swap(q_); // Take a snapshot of the queue
+
+    // Append the readiness callbacks
+    for (auto &event : ready_)
+      snapshot_.push_back(std::move(event));
+    ready_.clear();
+    firstTimer = snapshot_.size();
+
+    // Append the due delayed events
+    const auto now = clock_->now();
+    while (!timers_.empty() && timers_.front().due <= now) {
+      std::pop_heap(timers_.begin(), timers_.end(), later);
+      snapshot_.push_back(std::move(timers_.back().event));
+      timers_.pop_back();
+    }
+
+    // Posts made while the batch runs signal pollFd() again
+    if (driver_ == Driver::Host && reactor_)
+      reactor_->prepareSleep();
+  }
+  // Handle events in the snapshot
+  timersCancelled_ = false;
+  std::size_t handled{0};
+  for (auto &event : snapshot_) {
+    if (timersCancelled_ && handled >= firstTimer)
+      break; // The remaining ones are cancelled delayed events
+    ++handled;
+    try {
+      event(); // Handle event
+    } catch (...) {
+      report(std::current_exception());
     }
   }
+  snapshot_.clear(); // Release the handled events but keep the buffers
+  return handled;
 }
 
 } // namespace helios::core
@@ -0,0 +1,84 @@
+#include "core/clock.hpp"
+
+namespace helios::core {
+
+void SteadyClock::sleep(std::unique_lock<std::mutex> &lock,
+                        std::condition_variable &cv,
+                        std::optional<TimePoint> due) {
+  if (due)
+    cv.wait_until(lock, *due);
+  else
+    cv.wait(lock);
+}
+
+Clock::TimePoint VirtualClock::now() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return now_;
+}
+
+void VirtualClock::attach(std::condition_variable &cv) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  participants_[&cv] = Participant{};
+}
+
+void VirtualClock::detach(std::condition_variable &cv) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  participants_.erase(&cv);
+  advance(); // It may have been the last busy one
+}
+
+void VirtualClock::sleep(std::unique_lock<std::mutex> &lock,
+                         std::condition_variable &cv,
+                         std::optional<TimePoint> due) {
+  // The participant sleeps on the lock of the clock, so the clock decides
+  // alone whether all participants are idle
+  lock.unlock();
+  {
+    std::unique_lock<std::mutex> clockLock(mtx_);
+    Participant &p = participants_.at(&cv);
+    if (!p.woken && !(due && *due <= now_)) {
+      p.idle = true;
+      p.due = due;
+      advance();
+      cv_.wait(clockLock, [&p] { return !p.idle; });
+    }
+    p.idle = false;
+    p.woken = false;
+    p.due.reset();
+  }
+  lock.lock();
+}
+
+void VirtualClock::wake(std::condition_variable &cv) {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = participants_.find(&cv);
+    if (it == participants_.end())
+      return;
+    // Busy from now on, so the clock waits for the participant
+    it->second.woken = true;
+    it->second.idle = false;
+  }
+  cv_.notify_all();
+}
+
+void VirtualClock::advance() {
+  std::optional<TimePoint> next;
+  for (const auto &[cv, p] : participants_) {
+    if (!p.idle)
+      return;
+    if (p.due && (!next || *p.due < *next))
+      next = p.due;
+  }
+  if (!next)
+    return; // Idle until an event comes from outside
+  if (*next > now_)
+    now_ = *next;
+  for (auto &[cv, p] : participants_) {
+    if (p.due && *p.due <= now_)
+      p.idle = false;
+  }
+  cv_.notify_all();
+}
+
+} // namespace helios::core
@@ -1,22 +1,69 @@
 #include "core/in_active_h_object.hpp"
 
+#include <chrono>
 #include <future>
 
 namespace helios::core {
 
 InActiveHObject::InActiveHObject(std::shared_ptr<HLoop> loop,
                                  std::shared_ptr<HBus> hBus)
-    : HObject(std::move(hBus)), loop_(loop) {}
+    : HObject(std::move(hBus)), loop_(loop),
+      timerGen_(std::make_shared<std::atomic<std::uint64_t>>(0)) {}
 
 InActiveHObject::~InActiveHObject() {
-  // Post a stop event
+  cancelTimers();
+  drain();
+}
+
+void InActiveHObject::drain() { sync(false); }
+
+void InActiveHObject::cancelTimers() {
+  if (runsInCurrentThread()) {
+    dropTimers(); // Nothing else runs the loop meanwhile
+    return;
+  }
+  sync(true);
+}
+
+void InActiveHObject::sync(bool cancel) {
+  // Post a marker event behind the queued ones
   std::promise<void> finished;
-  loop_->post([this, &finished] {
+  loop_->post([this, cancel, &finished] {
+    if (cancel)
+      dropTimers();
     finished.set_value(); // Indicate that the event has executed
   });
-  finished.get_future().get(); // Wait for the stop event to be executed
+  auto done = finished.get_future();
+  if (loop_->hostDriven() && loop_->runsInCurrentThread()) {
+    // Nobody else runs the loop
+    while (done.wait_for(std::chrono::seconds(0)) !=
+           std::future_status::ready)
+      loop_->poll();
+    return;
+  }
+  done.get(); // Wait for the marker event to be executed
+}
+
+void InActiveHObject::dropTimers() {
+  ++*timerGen_; // Skip those taken for the running batch
+  loop_->eraseTimers(this);
+}
+
+bool InActiveHObject::runsInCurrentThread() const {
+  return loop_->runsInCurrentThread();
 }
 
 void InActiveHObject::postImpl(Event e) { loop_->post(std::move(e)); }
 
+void InActiveHObject::postAtImpl(Clock::TimePoint due, Event e) {
+  loop_->postAt(due, this,
+                [gen = timerGen_, expected = timerGen_->load(),
+                 e = std::move(e)]() mutable {
+                  if (gen->load() == expected)
+                    e();
+                });
+}
+
+void InActiveHObject::execute(Event e) { loop_->post(std::move(e)); }
+
 } // namespace helios::core
@@ -0,0 +1,42 @@
+#include "core/memory_resource.hpp"
+
+#include <atomic>
+
+namespace {
+
+/**
+ * @brief Returns the default memory resource.
+ *
+ * @note
+ * - Never destroyed, so that objects released during static destruction can
+ *   still return their memory.
+ */
+std::pmr::memory_resource *defaultResource() {
+  static auto *resource = new std::pmr::synchronized_pool_resource();
+  return resource;
+}
+
+/**
+ * @brief Memory resource currently used on the request path.
+ */
+std::atomic<std::pmr::memory_resource *> &currentResource() {
+  static std::atomic<std::pmr::memory_resource *> resource{defaultResource()};
+  return resource;
+}
+
+} // namespace
+
+namespace helios::core {
+
+std::pmr::memory_resource *requestMemoryResource() noexcept {
+  return currentResource().load(std::memory_order_acquire);
+}
+
+std::pmr::memory_resource *
+setRequestMemoryResource(std::pmr::memory_resource *resource) noexcept {
+  if (!resource)
+    resource = defaultResource();
+  return currentResource().exchange(resource, std::memory_order_acq_rel);
+}
+
+} // namespace helios::core
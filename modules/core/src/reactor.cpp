@@ -0,0 +1,111 @@
+#include "reactor.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Builds the epoll data of a registration.
+ */
+std::uint64_t keyOf(int fd, std::uint32_t seq) {
+  return (static_cast<std::uint64_t>(seq) << 32) |
+         static_cast<std::uint32_t>(fd);
+}
+
+} // namespace
+
+namespace helios::core {
+
+Reactor::Reactor() : events_(64) {
+  epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+  if (epollFd_ < 0)
+    throw std::system_error(errno, std::generic_category(), "epoll_create1");
+  wakeFd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wakeFd_ < 0) {
+    const int err = errno;
+    ::close(epollFd_);
+    throw std::system_error(err, std::generic_category(), "eventfd");
+  }
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.u64 = WAKE_KEY;
+  ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+}
+
+Reactor::~Reactor() {
+  ::close(wakeFd_);
+  ::close(epollFd_);
+}
+
+bool Reactor::watch(int fd, std::uint32_t events, Callback cb) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (watches_.count(fd) != 0)
+    return false;
+  const std::uint32_t seq = ++lastSeq_;
+  epoll_event ev{};
+  ev.events = events;
+  ev.data.u64 = keyOf(fd, seq);
+  if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) != 0)
+    return false;
+  watches_.emplace(fd, Watch{seq, std::make_shared<Callback>(std::move(cb))});
+  return true;
+}
+
+bool Reactor::modify(int fd, std::uint32_t events) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = watches_.find(fd);
+  if (it == watches_.end())
+    return false;
+  epoll_event ev{};
+  ev.events = events;
+  ev.data.u64 = keyOf(fd, it->second.seq);
+  return ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+bool Reactor::unwatch(int fd) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (watches_.erase(fd) == 0)
+    return false;
+  // Fails harmlessly if the descriptor was already closed
+  ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+  return true;
+}
+
+void Reactor::wait(int timeoutMs, std::deque<Event> &ready) {
+  const int n = ::epoll_wait(epollFd_, events_.data(),
+                             static_cast<int>(events_.size()), timeoutMs);
+  sleeping_.store(false);
+  if (n <= 0)
+    return; // Timeout or signal
+  std::lock_guard<std::mutex> lock(mtx_);
+  for (int i{0}; i < n; ++i) {
+    const std::uint64_t key = events_[i].data.u64;
+    if (key == WAKE_KEY) {
+      std::uint64_t count;
+      [[maybe_unused]] auto r = ::read(wakeFd_, &count, sizeof(count));
+      continue;
+    }
+    auto it = watches_.find(static_cast<int>(static_cast<std::uint32_t>(key)));
+    if (it == watches_.end() || it->second.seq != key >> 32)
+      continue; // Unwatched since
+    ready.emplace_back([cb = it->second.cb, events = events_[i].events] {
+      (*cb)(events);
+    });
+  }
+  // A full buffer hints at more descriptors being ready at once
+  if (static_cast<std::size_t>(n) == events_.size())
+    events_.resize(events_.size() * 2);
+}
+
+void Reactor::wake() {
+  if (!sleeping_.exchange(false))
+    return; // Busy, it looks at its queue before sleeping again
+  const std::uint64_t one{1};
+  [[maybe_unused]] auto r = ::write(wakeFd_, &one, sizeof(one));
+}
+
+} // namespace helios::core
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/epoll.h>
+
+#include "core/event.hpp"
+
+namespace helios::core {
+
+/**
+ * @class core::Reactor
+ *
+ * @brief Waits for file descriptor readiness and wake-ups of an event loop
+ *        with epoll.
+ *
+ * @details
+ * - Wake-ups come through an eventfd in the same epoll set. A wake-up is
+ *   only written while the loop sleeps, so posting to a busy loop costs no
+ *   system call.
+ * - Each registration gets a sequence number that travels with the epoll
+ *   event, so a readiness reported for a descriptor that was unwatched or
+ *   watched again in the meantime is dropped.
+ *
+ * @note
+ * - watch(), modify(), unwatch() and wake() are thread-safe. The other
+ *   functions are called from the loop thread.
+ */
+class Reactor {
+public:
+  /**
+   * @brief Type aliases.
+   */
+  using Callback = std::function<void(std::uint32_t events)>;
+
+  /**
+   * @brief Constructor.
+   *
+   * @throws std::system_error if the epoll set or the eventfd can't be
+   *         created.
+   */
+  Reactor();
+
+  /**
+   * @brief Destructor.
+   */
+  ~Reactor();
+
+  /**
+   * @brief Delete copy and move semantics.
+   */
+  Reactor(const Reactor &) = delete;
+  Reactor &operator=(const Reactor &) = delete;
+  Reactor(Reactor &&) = delete;
+  Reactor &operator=(Reactor &&) = delete;
+
+  /**
+   * @brief Starts watching a file descriptor.
+   *
+   * @return False if it is already watched or epoll refuses it.
+   */
+  bool watch(int fd, std::uint32_t events, Callback cb);
+
+  /**
+   * @brief Changes the events of a watched file descriptor.
+   *
+   * @return False if it is not watched or epoll refuses the change.
+   */
+  bool modify(int fd, std::uint32_t events);
+
+  /**
+   * @brief Stops watching a file descriptor.
+   *
+   * @return False if it is not watched.
+   */
+  bool unwatch(int fd);
+
+  /**
+   * @brief Returns the epoll file descriptor. Readable while a watched
+   *        descriptor is ready or a wake-up is pending.
+   */
+  int fd() const { return epollFd_; }
+
+  /**
+   * @brief Marks the loop as about to sleep. Called with the loop lock held,
+   *        after its queue was found empty.
+   */
+  void prepareSleep() { sleeping_.store(true); }
+
+  /**
+   * @brief Sleeps until readiness, a wake-up or a timeout. Called without
+   *        the loop lock.
+   *
+   * @param timeoutMs Timeout in milliseconds, -1 for none.
+   * @param ready The callbacks of the ready descriptors are appended here.
+   */
+  void wait(int timeoutMs, std::deque<Event> &ready);
+
+  /**
+   * @brief Wakes the loop if it sleeps.
+   */
+  void wake();
+
+private:
+  /**
+   * @brief Registered file descriptor.
+   */
+  struct Watch {
+    std::uint32_t seq;
+    std::shared_ptr<Callback> cb; // Shared with the events in flight
+  }; // struct Watch
+
+  /**
+   * @brief Epoll data of the eventfd.
+   */
+  static constexpr std::uint64_t WAKE_KEY = UINT64_MAX;
+
+  /**
+   * @brief Epoll file descriptor.
+   */
+  int epollFd_{-1};
+
+  /**
+   * @brief Eventfd of the wake-ups.
+   */
+  int wakeFd_{-1};
+
+  /**
+   * @brief True while the loop sleeps or is about to, or while the host of
+   *        a host-driven loop may wait on fd().
+   */
+  std::atomic<bool> sleeping_{false};
+
+  /**
+   * @brief Protects the registrations.
+   */
+  std::mutex mtx_;
+
+  /**
+   * @brief Registrations by file descriptor.
+   */
+  std::unordered_map<int, Watch> watches_;
+
+  /**
+   * @brief Sequence number of the last registration.
+   */
+  std::uint32_t lastSeq_{0};
+
+  /**
+   * @brief Buffer of epoll_wait(). Used by the loop thread only.
+   */
+  std::vector<epoll_event> events_;
+}; // class Reactor
+
+} // namespace helios::core
@@ -2,7 +2,10 @@
 
 #include <future>
 #include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "core/future_result.hpp"
 
@@ -17,6 +20,19 @@ public:
   }
 }; // class Calculator
 
+class Squarer : public helios::core::ActiveHObject {
+public:
+  helios::core::FutureResult<int>::Ptr square(int value) {
+    return REQ_INLINE(int, { fut->set(value * value); });
+  }
+  helios::core::FutureResult<bool>::Ptr squareIsReadyInline(int value) {
+    return REQ(bool, {
+      auto squared = square(value);
+      fut->set(squared->get(std::chrono::milliseconds(0)).has_value());
+    });
+  }
+}; // class Squarer
+
 class Order : public helios::core::ActiveHObject {
 public:
   void postInOrder(std::vector<int> &v) {
@@ -34,6 +50,24 @@ public:
   }
 }; // class Thrower
 
+class Delayer : public helios::core::ActiveHObject {
+public:
+  ~Delayer() override { drain(); }
+  void postDelayed(std::vector<int> &result, std::promise<void> &done) {
+    using std::chrono::milliseconds;
+    postAfter(milliseconds(30), [&result, &done] {
+      result.push_back(3);
+      done.set_value();
+    });
+    postAfter(milliseconds(10), [&result] { result.push_back(1); });
+    postAfter(milliseconds(20), [&result] { result.push_back(2); });
+    postAt(clock().now(), [&result] { result.push_back(0); });
+  }
+  void postForever(int &counter) {
+    postAfter(std::chrono::hours(1), [&counter] { ++counter; });
+  }
+}; // class Delayer
+
 } // namespace
 
 /**
@@ -61,6 +95,24 @@ TEST(ActiveHObjectTest, HObjectCatchesExceptions) {
   t.throwException();
 }
 
+/**
+ * @brief The error handler receives the exceptions thrown from events.
+ */
+TEST(ActiveHObjectTest, ErrorHandlerReceivesExceptions) {
+  std::promise<std::string> reported;
+  Thrower t;
+  t.onError([&reported](std::exception_ptr error) {
+    try {
+      std::rethrow_exception(error);
+    } catch (const std::runtime_error &e) {
+      reported.set_value(e.what());
+    }
+  });
+  t.throwException();
+  EXPECT_EQ(reported.get_future().get(),
+            "Testing that the HObject catches exceptions");
+}
+
 /**
  * @brief ActiveHObject runs events in order.
  */
@@ -74,3 +126,50 @@ TEST(ActiveHObjectTest, ExecutesEventsInOrder) {
   for (int i{0}; i < 10; ++i)
     EXPECT_EQ(result[i], i);
 }
+
+/**
+ * @brief REQ_INLINE runs the request directly when called from the loop thread.
+ *
+ * @details
+ * - Called from another thread, the request shall be posted.
+ * - Called from the loop thread, the result shall be ready on return.
+ */
+TEST(ActiveHObjectTest, ReqInlineRunsDirectlyInLoopThread) {
+  Squarer s;
+  std::optional<int> squared = s.square(3)->get();
+  ASSERT_NE(squared, std::nullopt);
+  EXPECT_EQ(*squared, 9);
+  std::optional<bool> readyInline = s.squareIsReadyInline(3)->get();
+  ASSERT_NE(readyInline, std::nullopt);
+  EXPECT_TRUE(*readyInline);
+}
+
+/**
+ * @brief Delayed events run by deadline, not by posting order.
+ *
+ * @details
+ * - The last event shall not run before its delay has passed.
+ */
+TEST(ActiveHObjectTest, DelayedEventsRunByDeadline) {
+  Delayer d;
+  std::vector<int> result;
+  std::promise<void> done;
+  const auto start = std::chrono::steady_clock::now();
+  d.postDelayed(result, done);
+  done.get_future().wait();
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(30));
+  EXPECT_EQ(result, (std::vector<int>{0, 1, 2, 3}));
+}
+
+/**
+ * @brief Delayed events that are not due are dropped on destruction.
+ */
+TEST(ActiveHObjectTest, PendingDelayedEventsAreDropped) {
+  int counter{0};
+  {
+    Delayer d;
+    d.postForever(counter);
+  }
+  EXPECT_EQ(counter, 0);
+}
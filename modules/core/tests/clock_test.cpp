@@ -0,0 +1,99 @@
+#include "core/clock.hpp"
+
+#include <future>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/h_loop.hpp"
+#include "core/in_active_h_object.hpp"
+
+namespace {
+
+using helios::core::Clock;
+
+class Ticker : public helios::core::InActiveHObject {
+public:
+  Ticker(std::shared_ptr<helios::core::HLoop> loop,
+         std::shared_ptr<Clock> clock)
+      : helios::core::InActiveHObject(loop), clock_(clock) {}
+  void tick(int remaining, std::vector<Clock::TimePoint> &times,
+            std::promise<void> &done) {
+    postAfter(std::chrono::minutes(1), [this, remaining, &times, &done] {
+      times.push_back(clock_->now());
+      if (remaining > 1)
+        tick(remaining - 1, times, done);
+      else
+        done.set_value();
+    });
+  }
+  void mark(Clock::TimePoint due, std::mutex &mtx,
+            std::vector<Clock::TimePoint> &times) {
+    postAt(due, [this, &mtx, &times] {
+      std::lock_guard<std::mutex> lock(mtx);
+      times.push_back(clock_->now());
+    });
+  }
+
+private:
+  std::shared_ptr<Clock> clock_;
+}; // class Ticker
+
+} // namespace
+
+/**
+ * @brief A virtual clock jumps from one deadline to the next.
+ *
+ * @details
+ * - A simulated hour shall pass in well under a second, and every event
+ *   shall run exactly at its deadline.
+ */
+TEST(ClockTest, VirtualClockJumpsToDeadlines) {
+  auto clock = std::make_shared<helios::core::VirtualClock>();
+  auto loop = std::make_shared<helios::core::HLoop>(clock);
+  Ticker ticker(loop, clock);
+  std::vector<Clock::TimePoint> times;
+  std::promise<void> done;
+  const auto start = clock->now();
+  const auto wallStart = std::chrono::steady_clock::now();
+  ticker.tick(60, times, done);
+  done.get_future().get();
+  EXPECT_LT(std::chrono::steady_clock::now() - wallStart,
+            std::chrono::seconds(5));
+  ASSERT_EQ(times.size(), 60u);
+  for (int k{0}; k < 60; ++k)
+    EXPECT_EQ(times[k] - start, std::chrono::minutes(k + 1));
+}
+
+/**
+ * @brief Loops sharing a virtual clock run their delayed events in order of
+ *        their deadlines.
+ */
+TEST(ClockTest, VirtualClockOrdersLoops) {
+  auto clock = std::make_shared<helios::core::VirtualClock>();
+  auto first = std::make_shared<helios::core::HLoop>(clock);
+  auto second = std::make_shared<helios::core::HLoop>(clock);
+  std::mutex mtx;
+  std::vector<Clock::TimePoint> times;
+  {
+    Ticker a(first, clock);
+    Ticker b(second, clock);
+    // Posted from a loop, so the clock waits until all are posted
+    first->post([&] {
+      const auto start = clock->now();
+      a.mark(start + std::chrono::minutes(30), mtx, times);
+      b.mark(start + std::chrono::minutes(20), mtx, times);
+      a.mark(start + std::chrono::minutes(10), mtx, times);
+    });
+    for (;;) {
+      std::lock_guard<std::mutex> lock(mtx);
+      if (times.size() == 3)
+        break;
+    }
+  }
+  std::lock_guard<std::mutex> lock(mtx);
+  ASSERT_EQ(times.size(), 3u);
+  for (int k{0}; k < 3; ++k)
+    EXPECT_EQ(times[k] - Clock::TimePoint{}, std::chrono::minutes(10 + 10 * k));
+}
@@ -0,0 +1,143 @@
+#include "core/embedded_h_loop.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "core/in_active_h_object.hpp"
+
+namespace {
+
+class Counter : public helios::core::InActiveHObject {
+public:
+  Counter(std::shared_ptr<helios::core::HLoop> loop)
+      : helios::core::InActiveHObject(loop) {}
+  helios::core::FutureResult<int>::Ptr increment() {
+    return REQ(int, {
+      if (!runsInCurrentThread())
+        throw std::runtime_error("Not on the loop thread");
+      fut->set(++count_);
+    });
+  }
+  void incrementLater(std::chrono::milliseconds delay) {
+    postAfter(delay, [this] { ++count_; });
+  }
+  int count() const { return count_; }
+
+private:
+  int count_{0};
+}; // class Counter
+
+/**
+ * @brief Returns true if a file descriptor becomes readable in time.
+ */
+bool readable(int fd, int timeoutMs) {
+  pollfd pfd{fd, POLLIN, 0};
+  return ::poll(&pfd, 1, timeoutMs) == 1 && (pfd.revents & POLLIN);
+}
+
+} // namespace
+
+/**
+ * @brief Events run inline on the host thread when it polls the loop.
+ *
+ * @details
+ * - Verifies that nothing runs before poll() and that the events run on the
+ *   thread that created the loop.
+ */
+TEST(EmbeddedHLoopTest, PollRunsEventsOnHostThread) {
+  auto loop = std::make_shared<helios::core::EmbeddedHLoop>();
+  Counter counter(loop);
+  EXPECT_TRUE(loop->runsInCurrentThread());
+  auto first = counter.increment();
+  auto second = counter.increment();
+  EXPECT_EQ(first->get(std::chrono::milliseconds(0)), std::nullopt);
+  EXPECT_EQ(loop->pollTimeout(), 0);
+  EXPECT_EQ(loop->poll(), 2u);
+  EXPECT_EQ(first->get(), 1);
+  EXPECT_EQ(second->get(), 2);
+  EXPECT_EQ(loop->poll(), 0u);
+  EXPECT_EQ(loop->pollTimeout(), -1);
+}
+
+/**
+ * @brief The loop file descriptor signals posts from other threads and
+ *        watched descriptors.
+ *
+ * @details
+ * - Verifies that a host waiting on pollFd() wakes up for them and runs them
+ *   with poll().
+ */
+TEST(EmbeddedHLoopTest, PollFdSignalsWork) {
+  auto loop = std::make_shared<helios::core::EmbeddedHLoop>();
+  ASSERT_GE(loop->pollFd(), 0);
+  EXPECT_FALSE(readable(loop->pollFd(), 0));
+
+  // Post from another thread
+  Counter counter(loop);
+  std::thread([&counter] { counter.increment(); }).join();
+  ASSERT_TRUE(readable(loop->pollFd(), 1000));
+  EXPECT_EQ(loop->poll(), 1u);
+  EXPECT_EQ(counter.count(), 1);
+  EXPECT_FALSE(readable(loop->pollFd(), 0));
+
+  // Watched descriptor
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+  std::atomic<bool> called{false};
+  ASSERT_TRUE(loop->watch(fds[0], EPOLLIN, [&](std::uint32_t) {
+    char c;
+    called = ::read(fds[0], &c, 1) == 1 && loop->runsInCurrentThread();
+  }));
+  ASSERT_EQ(::write(fds[1], "x", 1), 1);
+  ASSERT_TRUE(readable(loop->pollFd(), 1000));
+  EXPECT_EQ(loop->poll(), 1u);
+  EXPECT_TRUE(called);
+  loop->unwatch(fds[0]);
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+/**
+ * @brief runFor() runs the delayed events that become due meanwhile.
+ *
+ * @details
+ * - Verifies that pollTimeout() tells the host when the next one is due.
+ */
+TEST(EmbeddedHLoopTest, RunForRunsDelayedEvents) {
+  auto loop = std::make_shared<helios::core::EmbeddedHLoop>();
+  Counter counter(loop);
+  counter.incrementLater(std::chrono::milliseconds(20));
+  const int timeout = loop->pollTimeout();
+  EXPECT_GT(timeout, 0);
+  EXPECT_LE(timeout, 20);
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(loop->runFor(std::chrono::milliseconds(50)), 1u);
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(50));
+  EXPECT_EQ(counter.count(), 1);
+}
+
+/**
+ * @brief An object destroyed on the host thread runs its pending events
+ *        without the host polling.
+ */
+TEST(EmbeddedHLoopTest, DestroyOnHostThreadRunsPendingEvents) {
+  auto loop = std::make_shared<helios::core::EmbeddedHLoop>(
+      nullptr, helios::core::HLoop::Engine::CondVar
+  );
+  EXPECT_EQ(loop->pollFd(), -1);
+  helios::core::FutureResult<int>::Ptr result;
+  {
+    Counter counter(loop);
+    result = counter.increment();
+  }
+  EXPECT_EQ(result->get(std::chrono::milliseconds(0)), 1);
+}
@@ -5,6 +5,7 @@
 #include <thread>
 
 #include "core/active_h_object.hpp"
+#include "core/h_loop.hpp"
 
 namespace {
 
@@ -14,6 +15,21 @@ public:
     auto handleAdd = [first, second](auto fut) { fut->set(first + second); };
     return REQ_CALLABLE(int, handleAdd);
   };
+  helios::core::FutureResult<void>::Ptr reset() {
+    return REQ(void, { fut->set(); });
+  }
+  helios::core::FutureResult<std::unique_ptr<int>>::Ptr boxed(int value) {
+    return REQ(std::unique_ptr<int>, {
+      fut->set(std::make_unique<int>(value));
+    });
+  }
+  helios::core::FutureResult<int>::Ptr divide(int first, int second) {
+    return REQ(int, {
+      if (second == 0)
+        throw std::invalid_argument("Division by zero");
+      fut->set(first / second);
+    });
+  }
 }; // class Calculator
 
 class Client : public helios::core::ActiveHObject {
@@ -32,6 +48,15 @@ public:
     calculator_->add(first, second) THEN_POST_CALLABLE(cb);
     return fut;
   }
+  std::future<bool> start_3(int first, int second) {
+    auto pr = std::make_shared<std::promise<bool>>();
+    std::future<bool> fut = pr->get_future();
+    auto onResult = [pr](std::shared_ptr<int>) { pr->set_value(false); };
+    auto onError = [pr](std::exception_ptr e) { pr->set_value(e != nullptr); };
+    calculator_->divide(first, second)
+        THEN_POST_CALLABLE(onResult) CATCH_POST_CALLABLE(onError);
+    return fut;
+  }
 
 private:
   std::promise<int> pr_;
@@ -155,3 +180,129 @@ TEST(FutureResultTest, GetPtrReturnsDueToTimeout) {
   auto value = result.getPtr(std::chrono::milliseconds(100));
   EXPECT_EQ(value, nullptr);
 }
+
+/**
+ * @brief setException() wakes a blocked get().
+ *
+ * @details
+ * - The consumer thread shall block on get() without a timeout.
+ * - The producer thread shall set an exception which shall be rethrown by get().
+ */
+TEST(FutureResultTest, SetExceptionWakesGet) {
+  helios::core::FutureResult<int> result;
+  std::thread producer{[&result] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    result.setException(
+        std::make_exception_ptr(std::runtime_error("Producer failed"))
+    );
+  }};
+  EXPECT_THROW(result.get(), std::runtime_error);
+  producer.join();
+  EXPECT_THROW(result.getPtr(), std::runtime_error);
+}
+
+/**
+ * @brief Only the first result or exception is kept.
+ */
+TEST(FutureResultTest, FirstCompletionWins) {
+  helios::core::FutureResult<int> result;
+  result.set(5);
+  result.setException(
+      std::make_exception_ptr(std::runtime_error("Ignored exception"))
+  );
+  auto value = result.get();
+  ASSERT_NE(value, std::nullopt);
+  EXPECT_EQ(*value, 5);
+}
+
+/**
+ * @brief An exception thrown from a REQ body fails the result.
+ *
+ * @details
+ * - get() shall rethrow the exception instead of blocking.
+ * - The error shall flow to the CATCH_POST callback instead of THEN_POST.
+ */
+TEST(FutureResultTest, ReqBodyThrows) {
+  auto c = std::make_shared<Calculator>();
+  EXPECT_THROW(c->divide(1, 0)->get(), std::invalid_argument);
+  Client client(c);
+  EXPECT_TRUE(client.start_3(1, 0).get());
+  EXPECT_FALSE(client.start_3(4, 2).get());
+}
+
+/**
+ * @brief then() with an executor runs the callback in the executor's thread.
+ *
+ * @details
+ * - The result shall be set from the test thread.
+ * - The callback shall run in the loop thread.
+ */
+TEST(FutureResultTest, ThenRunsOnExecutor) {
+  auto loop = std::make_shared<helios::core::HLoop>();
+  helios::core::FutureResult<int> result;
+  std::promise<bool> ranOnLoop;
+  auto cb = [&ranOnLoop, l = loop.get()](std::shared_ptr<int> value) {
+    ranOnLoop.set_value(*value == 5 && l->runsInCurrentThread());
+  };
+  result.then(*loop, cb);
+  result.set(5);
+  EXPECT_TRUE(ranOnLoop.get_future().get());
+}
+
+/**
+ * @brief then() with an executor runs the callback directly if the result is
+ *        set from the executor's thread.
+ */
+TEST(FutureResultTest, ThenRunsInlineOnExecutorThread) {
+  auto loop = std::make_shared<helios::core::HLoop>();
+  helios::core::FutureResult<int> result;
+  bool called{false};
+  result.then(*loop, [&called](std::shared_ptr<int>) { called = true; });
+  std::promise<bool> calledBeforeReturn;
+  loop->post([&] {
+    result.set(5);
+    calledBeforeReturn.set_value(called);
+  });
+  EXPECT_TRUE(calledBeforeReturn.get_future().get());
+}
+
+/**
+ * @brief take() moves a move-only result out.
+ */
+TEST(FutureResultTest, TakeMoveOnlyResult) {
+  auto c = std::make_shared<Calculator>();
+  std::optional<std::unique_ptr<int>> value = c->boxed(7)->take();
+  ASSERT_NE(value, std::nullopt);
+  ASSERT_NE(*value, nullptr);
+  EXPECT_EQ(**value, 7);
+}
+
+/**
+ * @brief take() does not copy the result.
+ *
+ * @details
+ * - The buffer taken from the result shall be the one that was set.
+ */
+TEST(FutureResultTest, TakeDoesNotCopy) {
+  helios::core::FutureResult<std::vector<int>> result;
+  std::vector<int> buffer(1024, 1);
+  const int *data = buffer.data();
+  result.set(std::move(buffer));
+  std::optional<std::vector<int>> value = result.take();
+  ASSERT_NE(value, std::nullopt);
+  EXPECT_EQ(value->data(), data);
+}
+
+/**
+ * @brief FutureResult<void> signals completion.
+ */
+TEST(FutureResultTest, VoidResult) {
+  auto c = std::make_shared<Calculator>();
+  auto fut = c->reset();
+  EXPECT_TRUE(fut->get().has_value());
+  bool called{false};
+  fut->then([&called](std::shared_ptr<void>) { called = true; });
+  EXPECT_TRUE(called);
+  helios::core::FutureResult<void> pending;
+  EXPECT_FALSE(pending.get(std::chrono::milliseconds(10)).has_value());
+}
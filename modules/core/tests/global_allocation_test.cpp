@@ -0,0 +1,77 @@
+#include "core/memory_resource.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <new>
+
+#include "core/active_h_object.hpp"
+
+// Built as its own executable, since it replaces the global operator new
+
+namespace {
+
+/**
+ * @brief Set while the global allocations are counted.
+ */
+std::atomic<bool> counting{false};
+
+/**
+ * @brief Number of calls to the global operator new while counting.
+ */
+std::atomic<std::size_t> globalAllocations{0};
+
+/**
+ * @brief Counts the global allocations during its lifetime.
+ */
+class CountingScope {
+public:
+  CountingScope() {
+    globalAllocations = 0;
+    counting = true;
+  }
+  ~CountingScope() { counting = false; }
+  std::size_t allocations() const { return globalAllocations; }
+}; // class CountingScope
+
+class Calculator : public helios::core::ActiveHObject {
+public:
+  helios::core::FutureResult<int>::Ptr add(int first, int second) {
+    return REQ(int, { fut->set(first + second); });
+  }
+}; // class Calculator
+
+} // namespace
+
+void *operator new(std::size_t size) {
+  if (counting.load(std::memory_order_relaxed))
+    ++globalAllocations;
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+/**
+ * @brief Steady request traffic does not use the global allocator.
+ *
+ * @details
+ * - After warming up the pools, request round trips shall not call the
+ *   global operator new.
+ */
+TEST(GlobalAllocationTest, SteadyRequestsAvoidGlobalAllocator) {
+  Calculator c;
+  for (int i{}; i < 1000; ++i)
+    c.add(i, i)->get();
+  std::size_t allocations;
+  {
+    CountingScope scope;
+    for (int i{}; i < 1000; ++i)
+      c.add(i, i)->get();
+    allocations = scope.allocations();
+  }
+  EXPECT_EQ(allocations, 0u);
+}
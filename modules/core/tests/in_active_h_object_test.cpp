@@ -1,6 +1,14 @@
 #include "core/h_loop.hpp"
 
+#include <atomic>
+#include <future>
 #include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <sys/epoll.h>
+#include <unistd.h>
 
 #include "core/in_active_h_object.hpp"
 
@@ -17,6 +25,31 @@ public:
   }
 }; // class Calculator
 
+class Doubler : public helios::core::InActiveHObject {
+public:
+  Doubler(std::shared_ptr<helios::core::HLoop> loop)
+      : helios::core::InActiveHObject(loop) {}
+  helios::core::FutureResult<int>::Ptr twice(int value) {
+    return REQ_INLINE(int, { fut->set(2 * value); });
+  }
+}; // class Doubler
+
+class Caller : public helios::core::InActiveHObject {
+public:
+  Caller(std::shared_ptr<helios::core::HLoop> loop,
+         std::shared_ptr<Doubler> doubler)
+      : helios::core::InActiveHObject(loop), doubler_(doubler) {}
+  helios::core::FutureResult<bool>::Ptr callIsReadyInline(int value) {
+    return REQ(bool, {
+      auto doubled = doubler_->twice(value);
+      fut->set(doubled->get(std::chrono::milliseconds(0)).has_value());
+    });
+  }
+
+private:
+  std::shared_ptr<Doubler> doubler_;
+}; // class Caller
+
 class Worker : public helios::core::InActiveHObject {
 public:
   Worker(std::shared_ptr<helios::core::HLoop> loop)
@@ -26,6 +59,55 @@ public:
   }
 }; // class Worker
 
+class Timer : public helios::core::InActiveHObject {
+public:
+  Timer(std::shared_ptr<helios::core::HLoop> loop)
+      : helios::core::InActiveHObject(loop) {}
+  helios::core::FutureResult<bool>::Ptr inLoopAfter(
+      std::chrono::milliseconds delay) {
+    auto result = std::make_shared<helios::core::FutureResult<bool>>();
+    postAfter(delay, [this, result] { result->set(runsInCurrentThread()); });
+    return result;
+  }
+  void countAfter(std::chrono::milliseconds delay,
+                  std::shared_ptr<std::atomic<int>> counter) {
+    postAfter(delay, [counter] { ++*counter; });
+  }
+  using helios::core::InActiveHObject::cancelTimers;
+  using helios::core::InActiveHObject::drain;
+}; // class Timer
+
+class PipeReader : public helios::core::InActiveHObject {
+public:
+  PipeReader(std::shared_ptr<helios::core::HLoop> loop, int fd)
+      : helios::core::InActiveHObject(loop), fd_(fd) {}
+  ~PipeReader() override { unwatch(fd_); }
+  bool start(std::promise<std::string> &received) {
+    return watch(fd_, EPOLLIN, [this, &received](std::uint32_t events) {
+      char buf[16]{};
+      const auto n = ::read(fd_, buf, sizeof(buf));
+      if ((events & EPOLLIN) && n > 0 && runsInCurrentThread())
+        received.set_value(std::string(buf, static_cast<std::size_t>(n)));
+      unwatch(fd_);
+    });
+  }
+
+private:
+  int fd_;
+}; // class PipeReader
+
+class Spinner : public helios::core::InActiveHObject {
+public:
+  Spinner(std::shared_ptr<helios::core::HLoop> loop)
+      : helios::core::InActiveHObject(loop) {}
+  void spin(std::atomic<bool> &stop) {
+    post([this, &stop] {
+      if (!stop)
+        spin(stop);
+    });
+  }
+}; // class Spinner
+
 } // namespace
 
 /**
@@ -67,3 +149,151 @@ TEST(HLoopTest, MultipleEventsExecute) {
   }
   EXPECT_EQ(v->size(), 100);
 }
+
+/**
+ * @brief REQ_INLINE runs directly between objects sharing one HLoop.
+ *
+ * @details
+ * - The request of an object on the same loop shall be ready on return.
+ */
+TEST(HLoopTest, ReqInlineRunsDirectlyOnSharedLoop) {
+  auto loop = std::make_shared<helios::core::HLoop>();
+  auto doubler = std::make_shared<Doubler>(loop);
+  Caller caller(loop, doubler);
+  std::optional<bool> readyInline = caller.callIsReadyInline(4)->get();
+  ASSERT_NE(readyInline, std::nullopt);
+  EXPECT_TRUE(*readyInline);
+}
+
+/**
+ * @brief Delayed events of an InActiveHObject run on the thread of the loop.
+ */
+TEST(HLoopTest, DelayedEventRunsOnLoopThread) {
+  auto loop = std::make_shared<helios::core::HLoop>();
+  Timer timer(loop);
+  std::optional<bool> inLoop =
+      timer.inLoopAfter(std::chrono::milliseconds(5))->get();
+  ASSERT_NE(inLoop, std::nullopt);
+  EXPECT_TRUE(*inLoop);
+}
+
+/**
+ * @brief Delayed events of a destroyed InActiveHObject never run.
+ *
+ * @details
+ * - The loop outlives the object and shall drop its pending delayed events.
+ */
+TEST(HLoopTest, DelayedEventIsDroppedWithObject) {
+  auto loop = std::make_shared<helios::core::HLoop>();
+  auto counter = std::make_shared<std::atomic<int>>(0);
+  {
+    Timer timer(loop);
+    timer.countAfter(std::chrono::milliseconds(20), counter);
+  }
+  Timer other(loop);
+  other.countAfter(std::chrono::milliseconds(40), counter);
+  while (*counter == 0)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(*counter, 1);
+}
+
+/**
+ * @brief drain() keeps the pending delayed events, which only cancelTimers()
+ *        drops.
+ *
+ * @details
+ * - Verifies that cancelled events are erased from the loop at once, which
+ *   releases their captures.
+ */
+TEST(HLoopTest, CancelTimersDropsDelayedEvents) {
+  auto loop = std::make_shared<helios::core::HLoop>();
+  auto counter = std::make_shared<std::atomic<int>>(0);
+  Timer timer(loop);
+  timer.countAfter(std::chrono::milliseconds(10), counter);
+  timer.drain();
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (*counter == 0 && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_EQ(*counter, 1);
+
+  timer.countAfter(std::chrono::hours(1), counter);
+  EXPECT_EQ(counter.use_count(), 2);
+  timer.cancelTimers();
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+/**
+ * @brief An Epoll loop that never runs out of events still serves its file
+ *        descriptors.
+ */
+TEST(HLoopTest, BusyEpollLoopServesFileDescriptors) {
+  auto loop = std::make_shared<helios::core::HLoop>(
+      nullptr, helios::core::HLoop::Engine::Epoll
+  );
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+  std::atomic<bool> stop{false};
+  {
+    Spinner spinner(loop);
+    PipeReader reader(loop, fds[0]);
+    std::promise<std::string> received;
+    ASSERT_TRUE(reader.start(received));
+    spinner.spin(stop);
+    ASSERT_EQ(::write(fds[1], "busy", 4), 4);
+    auto text = received.get_future();
+    const bool served =
+        text.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+    stop = true;
+    ASSERT_TRUE(served);
+    EXPECT_EQ(text.get(), "busy");
+  }
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+/**
+ * @brief An Epoll loop runs readiness callbacks on its thread, along with
+ *        posted and delayed events.
+ */
+TEST(HLoopTest, EpollLoopWatchesFileDescriptors) {
+  auto loop = std::make_shared<helios::core::HLoop>(
+      nullptr, helios::core::HLoop::Engine::Epoll
+  );
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+  {
+    PipeReader reader(loop, fds[0]);
+    std::promise<std::string> received;
+    ASSERT_TRUE(reader.start(received));
+    EXPECT_FALSE(loop->watch(fds[0], EPOLLIN, [](std::uint32_t) {}));
+    ASSERT_EQ(::write(fds[1], "ping", 4), 4);
+    EXPECT_EQ(received.get_future().get(), "ping");
+
+    Timer timer(loop);
+    std::optional<bool> inLoop =
+        timer.inLoopAfter(std::chrono::milliseconds(5))->get();
+    ASSERT_NE(inLoop, std::nullopt);
+    EXPECT_TRUE(*inLoop);
+    Calculator calculator(loop);
+    std::optional<int> sum = calculator.add(2, 3)->get();
+    ASSERT_NE(sum, std::nullopt);
+    EXPECT_EQ(*sum, 5);
+  }
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+/**
+ * @brief Only the CondVar engine works with a virtual clock.
+ */
+TEST(HLoopTest, EpollLoopNeedsSteadyClock) {
+  EXPECT_THROW(helios::core::HLoop(
+                   std::make_shared<helios::core::VirtualClock>(),
+                   helios::core::HLoop::Engine::Epoll
+               ),
+               std::invalid_argument);
+  helios::core::HLoop loop;
+  EXPECT_FALSE(loop.watch(0, EPOLLIN, [](std::uint32_t) {}));
+}
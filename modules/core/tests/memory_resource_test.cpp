@@ -0,0 +1,54 @@
+#include "core/memory_resource.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+
+#include "core/active_h_object.hpp"
+
+namespace {
+
+class Calculator : public helios::core::ActiveHObject {
+public:
+  helios::core::FutureResult<int>::Ptr add(int first, int second) {
+    return REQ(int, { fut->set(first + second); });
+  }
+}; // class Calculator
+
+/**
+ * @brief Counts the allocations made through it.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+  std::atomic<std::size_t> allocations{0};
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+}; // class CountingResource
+
+} // namespace
+
+/**
+ * @brief Requests allocate from the plugged-in memory resource.
+ */
+TEST(MemoryResourceTest, RequestsUsePluggedResource) {
+  Calculator c;
+  CountingResource resource;
+  auto *previous = helios::core::setRequestMemoryResource(&resource);
+  {
+    auto res = c.add(1, 2)->get();
+    ASSERT_NE(res, std::nullopt);
+    EXPECT_EQ(*res, 3);
+  }
+  helios::core::setRequestMemoryResource(previous);
+  EXPECT_GE(resource.allocations, 3u); // FutureResult, its state and result
+}
@@ -4,6 +4,89 @@ set(LOG_FILE_PATH "logs/app.log" CACHE STRING "Path of the log file")
 # Logging sink options
 option(LOG_SINK_STDOUT "Enable stdout logging sink" ON)
 option(LOG_SINK_FILE "Enable file logging sink" OFF)
+option(LOG_SINK_BINARY "Enable binary file logging sink" OFF)
+option(LOG_SINK_MAPPED "Enable crash-safe memory-mapped logging sink" OFF)
+
+# Output formats of the text sinks
+set(LOG_STDOUT_FORMAT "Text" CACHE STRING "Output format of the stdout sink")
+set_property(CACHE LOG_STDOUT_FORMAT PROPERTY STRINGS Text Json Logfmt)
+set(LOG_FILE_FORMAT "Text" CACHE STRING "Output format of the file sink")
+set_property(CACHE LOG_FILE_FORMAT PROPERTY STRINGS Text Json Logfmt)
+
+# Binary log file path
+set(LOG_BINARY_FILE_PATH "logs/app.hlog" CACHE STRING
+    "Path of the binary log file")
+
+# Memory-mapped log file
+set(LOG_MAPPED_FILE_PATH "logs/app.hmap" CACHE STRING
+    "Path of the memory-mapped log file")
+set(LOG_MAPPED_SIZE "16777216" CACHE STRING
+    "Size of the memory-mapped log file in bytes")
+set(LOG_MAPPED_SLOT_SIZE "512" CACHE STRING
+    "Size of each message slot of the memory-mapped log file in bytes")
+
+# Buffering and flushing of the sinks
+set(LOG_BUFFER_SIZE "65536" CACHE STRING "Size of the sink buffers in bytes")
+set(LOG_FLUSH_EVERY "0" CACHE STRING
+    "Flush after this many messages, 0 to disable")
+set(LOG_FLUSH_INTERVAL_MS "100" CACHE STRING
+    "Flush at least this often in milliseconds, 0 to disable")
+set(LOG_FLUSH_LEVEL "Error" CACHE STRING
+    "Flush immediately on messages of this level or higher")
+set_property(CACHE LOG_FLUSH_LEVEL PROPERTY STRINGS Debug Info Warning Error)
+option(LOG_FSYNC "Call fsync() after every write of the sinks" OFF)
+
+# Rotation of the log file
+set(LOG_ROTATE_SIZE "0" CACHE STRING
+    "Rotate the log file before it exceeds this size in bytes, 0 to disable")
+set(LOG_ROTATE_INTERVAL_S "0" CACHE STRING
+    "Rotate the log file every this many seconds, 0 to disable")
+set(LOG_ROTATE_KEEP "0" CACHE STRING
+    "Number of rotated log files kept, 0 to keep all")
+option(LOG_ROTATE_COMPRESS "Compress rotated log files with zlib" ON)
+if(LOG_ROTATE_COMPRESS)
+    find_package(ZLIB)
+    if(NOT ZLIB_FOUND)
+        message(WARNING "zlib not found, rotated log files are not compressed")
+        set(LOG_ROTATE_COMPRESS OFF)
+    endif()
+endif()
+
+# Logging backend
+set(LOG_BACKEND "Bus" CACHE STRING "Backend moving log messages to the sinks")
+set_property(CACHE LOG_BACKEND PROPERTY STRINGS Bus Ring)
+if(LOG_BACKEND STREQUAL "Ring")
+    set(LOG_BACKEND_RING ON)
+else()
+    set(LOG_BACKEND_RING OFF)
+endif()
+
+# Capacity of the per-thread rings of the Ring backend
+set(LOG_RING_CAPACITY "4096" CACHE STRING "Messages per thread ring")
+
+# Bound of the log messages in flight
+set(LOG_QUEUE_CAPACITY "65536" CACHE STRING
+    "Max number of log messages queued for the sinks, 0 for no limit")
+set(LOG_OVERLOAD_POLICY "DropByLevel" CACHE STRING
+    "What happens to log messages while the queue is full")
+set_property(CACHE LOG_OVERLOAD_POLICY
+    PROPERTY STRINGS Block DropNewest DropByLevel)
+set(LOG_DROP_REPORT_INTERVAL_MS "1000" CACHE STRING
+    "Min time between two reports of dropped log messages in milliseconds")
+
+# Precision of the time stamps
+set(LOG_TIME_PRECISION "Seconds" CACHE STRING "Precision of log time stamps")
+set_property(CACHE LOG_TIME_PRECISION
+    PROPERTY STRINGS Seconds Milliseconds Microseconds Nanoseconds)
+if(LOG_TIME_PRECISION STREQUAL "Milliseconds")
+    set(LOG_TIME_DECIMALS 3)
+elseif(LOG_TIME_PRECISION STREQUAL "Microseconds")
+    set(LOG_TIME_DECIMALS 6)
+elseif(LOG_TIME_PRECISION STREQUAL "Nanoseconds")
+    set(LOG_TIME_DECIMALS 9)
+else()
+    set(LOG_TIME_DECIMALS 0)
+endif()
 
 # Minimum logging level
 set(MIN_LOG_LEVEL "Debug" CACHE STRING "Minimum compile-time log level")
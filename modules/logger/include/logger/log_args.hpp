@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace helios::logger {
+
+/**
+ * @brief Type of a deferred log argument.
+ */
+enum class ArgType : std::uint8_t { Bool, Char, Int, UInt, Double, String };
+
+/**
+ * @brief Static description of a deferred log statement.
+ *
+ * @details
+ * - 'fmt' points to the string literal of the call site. Each "{}" in it is
+ *   replaced by the next argument when the message is rendered.
+ * - A structured statement has no placeholders. Its arguments are fields, a
+ *   key followed by a value of the given type, and 'fmt' is the plain
+ *   message.
+ * - Only refers to static data, so it is copied into every message.
+ */
+struct LogFormat {
+  /**
+   * @brief Format string.
+   */
+  const char *fmt;
+
+  /**
+   * @brief Types of the arguments.
+   */
+  const ArgType *types;
+
+  /**
+   * @brief Number of arguments.
+   */
+  std::size_t count;
+
+  /**
+   * @brief True if the arguments are key/value pairs.
+   */
+  bool structured{false};
+}; // struct LogFormat
+
+/**
+ * @brief Returns the ArgType used to capture a value of type T.
+ */
+template <typename T> constexpr ArgType argTypeOf() {
+  using U = std::remove_cv_t<std::remove_reference_t<T>>;
+  if constexpr (std::is_same_v<U, bool>)
+    return ArgType::Bool;
+  else if constexpr (std::is_same_v<U, char>)
+    return ArgType::Char;
+  else if constexpr (std::is_enum_v<U>)
+    return argTypeOf<std::underlying_type_t<U>>();
+  else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+    return ArgType::Int;
+  else if constexpr (std::is_integral_v<U>)
+    return ArgType::UInt;
+  else if constexpr (std::is_floating_point_v<U>)
+    return ArgType::Double;
+  else if constexpr (std::is_convertible_v<const U &, std::string_view>)
+    return ArgType::String;
+  else
+    static_assert(sizeof(U) == 0, "Type can't be logged deferred, stream it");
+}
+
+/**
+ * @brief Argument types of a deferred log statement.
+ *
+ * @note
+ * - Has an extra element so that statements without arguments are valid.
+ */
+template <typename... Args>
+inline constexpr ArgType ARG_TYPES[sizeof...(Args) + 1] = {
+    argTypeOf<Args>()..., ArgType::Bool
+};
+
+/**
+ * @brief Key/value field of a structured statement.
+ *
+ * @tparam T Type of the value.
+ *
+ * @note
+ * - Only refers to the key and the value, so it shall not outlive the
+ *   statement.
+ */
+template <typename T> struct Field {
+  /**
+   * @brief Key of the field.
+   */
+  std::string_view key;
+
+  /**
+   * @brief Value of the field.
+   */
+  const T &value;
+}; // struct Field
+
+/**
+ * @brief Creates a key/value field of a structured statement.
+ *
+ * @param key Key of the field.
+ * @param value Value of the field. Numbers, characters and strings.
+ */
+template <typename T> Field<T> kv(std::string_view key, const T &value) {
+  return Field<T>{key, value};
+}
+
+/**
+ * @class logger::LogArgs
+ *
+ * @brief Raw bytes of the arguments of a deferred log statement.
+ *
+ * @details
+ * - Numbers are stored as 64-bit values, strings as a 16-bit length followed
+ *   by the characters. A field of a structured statement is its key as a
+ *   string followed by its value, and counts as one argument.
+ * - Strings that don't fit are truncated. Arguments that don't fit at all are
+ *   dropped and not counted, together with all later ones, so the stored
+ *   arguments stay aligned with their types. A field is dropped as a whole
+ *   if its key or the start of its value doesn't fit.
+ *
+ * @note
+ * - Not thread-safe.
+ */
+class LogArgs {
+public:
+  /**
+   * @brief Max number of argument bytes.
+   */
+  static constexpr std::size_t CAPACITY = 192;
+
+  /**
+   * @brief Appends an argument.
+   *
+   * @tparam T Type of the argument.
+   * @param value Argument.
+   */
+  template <typename T> void append(const T &value) {
+    constexpr ArgType type = argTypeOf<T>();
+    if constexpr (type == ArgType::String) {
+      if constexpr (std::is_pointer_v<T>) {
+        // Printed like the stream path does
+        appendString(value != nullptr ? std::string_view(value) : "(null)");
+      } else {
+        appendString(std::string_view(value));
+      }
+    } else if constexpr (type == ArgType::Double) {
+      appendValue(static_cast<double>(value));
+    } else if constexpr (type == ArgType::Int) {
+      appendValue(static_cast<std::int64_t>(value));
+    } else if constexpr (type == ArgType::UInt) {
+      appendValue(static_cast<std::uint64_t>(value));
+    } else {
+      appendValue(static_cast<char>(value));
+    }
+  }
+
+  /**
+   * @brief Appends a key/value field of a structured statement.
+   *
+   * @tparam T Type of the value.
+   * @param key Key of the field.
+   * @param value Value of the field.
+   */
+  template <typename T> void appendField(std::string_view key, const T &value) {
+    constexpr ArgType type = argTypeOf<T>();
+    std::size_t valueSize{sizeof(std::uint64_t)};
+    if constexpr (type == ArgType::String)
+      valueSize = sizeof(std::uint16_t); // A longer value is truncated
+    else if constexpr (type == ArgType::Bool || type == ArgType::Char)
+      valueSize = sizeof(char);
+    if (full_ ||
+        size_ + sizeof(std::uint16_t) + key.size() + valueSize > CAPACITY) {
+      full_ = true;
+      return;
+    }
+    const std::uint16_t count = count_;
+    appendString(key);
+    append(value);
+    count_ = count + 1;
+  }
+
+  /**
+   * @brief Returns the argument bytes.
+   */
+  const std::byte *data() const { return data_.data(); }
+
+  /**
+   * @brief Returns the number of argument bytes.
+   */
+  std::size_t size() const { return size_; }
+
+  /**
+   * @brief Returns the number of stored arguments.
+   */
+  std::size_t count() const { return count_; }
+
+private:
+  /**
+   * @brief Argument bytes.
+   */
+  std::array<std::byte, CAPACITY> data_;
+
+  /**
+   * @brief Number of used bytes.
+   */
+  std::uint16_t size_{0};
+
+  /**
+   * @brief Number of stored arguments.
+   */
+  std::uint16_t count_{0};
+
+  /**
+   * @brief Set once an argument was dropped.
+   */
+  bool full_{false};
+
+  /**
+   * @brief Appends the raw bytes of a number.
+   */
+  template <typename T> void appendValue(T value) {
+    if (full_ || size_ + sizeof(T) > CAPACITY) {
+      full_ = true;
+      return;
+    }
+    std::memcpy(data_.data() + size_, &value, sizeof(T));
+    size_ += sizeof(T);
+    ++count_;
+  }
+
+  /**
+   * @brief Appends the length and the characters of a string.
+   */
+  void appendString(std::string_view s) {
+    if (full_ || size_ + sizeof(std::uint16_t) > CAPACITY) {
+      full_ = true;
+      return;
+    }
+    auto len = static_cast<std::uint16_t>(
+        std::min(s.size(), CAPACITY - size_ - sizeof(std::uint16_t))
+    );
+    std::memcpy(data_.data() + size_, &len, sizeof(len));
+    std::memcpy(data_.data() + size_ + sizeof(len), s.data(), len);
+    size_ += sizeof(len) + len;
+    ++count_;
+  }
+}; // class LogArgs
+
+} // namespace helios::logger
@@ -11,18 +11,59 @@ constexpr bool LOG_ENABLED(LogLevel lvl) {
 
 } // namespace helios::logger
 
+/**
+ * @brief The compile-time check removes the statement entirely below
+ *        LOG_LEVEL_MIN. The runtime check is one relaxed atomic load, and the
+ *        message is only built if both pass.
+ */
+#define LOG_IF_ENABLED(lvl)                                                    \
+  if (helios::logger::LOG_ENABLED(helios::logger::LogLevel::lvl) &&            \
+      logger_.isEnabled(helios::logger::LogLevel::lvl))
+
 #define LOG_DEBUG                                                              \
-  if (helios::logger::LOG_ENABLED(helios::logger::LogLevel::Debug))            \
+  LOG_IF_ENABLED(Debug)                                                        \
   logger_.debug()
 
 #define LOG_INFO                                                               \
-  if (helios::logger::LOG_ENABLED(helios::logger::LogLevel::Info))             \
+  LOG_IF_ENABLED(Info)                                                         \
   logger_.info()
 
 #define LOG_WARN                                                               \
-  if (helios::logger::LOG_ENABLED(helios::logger::LogLevel::Warning))          \
+  LOG_IF_ENABLED(Warning)                                                      \
   logger_.warn()
 
 #define LOG_ERROR                                                              \
-  if (helios::logger::LOG_ENABLED(helios::logger::LogLevel::Error))            \
+  LOG_IF_ENABLED(Error)                                                        \
   logger_.error()
+
+#define LOGF_DEBUG(...)                                                        \
+  LOG_IF_ENABLED(Debug)                                                        \
+  logger_.debugf(__VA_ARGS__)
+
+#define LOGF_INFO(...)                                                         \
+  LOG_IF_ENABLED(Info)                                                         \
+  logger_.infof(__VA_ARGS__)
+
+#define LOGF_WARN(...)                                                         \
+  LOG_IF_ENABLED(Warning)                                                      \
+  logger_.warnf(__VA_ARGS__)
+
+#define LOGF_ERROR(...)                                                        \
+  LOG_IF_ENABLED(Error)                                                        \
+  logger_.errorf(__VA_ARGS__)
+
+#define LOGKV_DEBUG(...)                                                       \
+  LOG_IF_ENABLED(Debug)                                                        \
+  logger_.debugKv(__VA_ARGS__)
+
+#define LOGKV_INFO(...)                                                        \
+  LOG_IF_ENABLED(Info)                                                         \
+  logger_.infoKv(__VA_ARGS__)
+
+#define LOGKV_WARN(...)                                                        \
+  LOG_IF_ENABLED(Warning)                                                      \
+  logger_.warnKv(__VA_ARGS__)
+
+#define LOGKV_ERROR(...)                                                       \
+  LOG_IF_ENABLED(Error)                                                        \
+  logger_.errorKv(__VA_ARGS__)
@@ -6,36 +6,35 @@
 #include <sstream>
 #include <string>
 
-#include "log_level.hpp"
-
 namespace helios::logger {
 
 /**
  * @class logger::LogMessageFactory
  *
- * @brief Creates a log message that contains relevant information.
+ * @brief Collects the text of a streamed log message.
  *
  * @details
- * - The log message contains the following:
- *    1. Time stamp
- *    2. Tag
- *    3. Log level
- *    4. Log message
- * - Calls the given callback to give it the message when it is finished.
+ * - Records the time stamp when created.
+ * - Calls the given callback to give it the text when it is finished. The
+ *   time stamp, log level and tag are added by the sinks.
  * - All public functions are not thread-safe.
  * - All public functions are synchronous.
  */
 class LogMessageFactory {
 public:
+  /**
+   * @brief Type alias for the callback called when the message is finished.
+   */
+  using Callback = std::function<void(
+      std::chrono::system_clock::time_point timestamp, std::string body
+  )>;
+
   /**
    * @brief Constructor.
    *
-   * @param level Log level.
-   * @param tag Tag name.
    * @param cb Callback called when the message is finished.
    */
-  LogMessageFactory(LogLevel level, std::string tag,
-                    std::function<void(std::string)> cb);
+  explicit LogMessageFactory(Callback cb);
 
   /**
    * @brief Destructor.
@@ -54,20 +53,10 @@ public:
   }
 
 private:
-  /**
-   * @brief Log level.
-   */
-  LogLevel level_;
-
-  /**
-   * @brief Tag.
-   */
-  std::string tag_;
-
   /**
    * @brief Callback called when the message is finished.
    */
-  std::function<void(std::string)> cb_;
+  Callback cb_;
 
   /**
    * @brief Time stamp when the object was created.
@@ -78,13 +67,6 @@ private:
    * @brief Buffer to hold the log message in between calls.
    */
   std::ostringstream buffer_;
-
-  /**
-   * @brief Formats 'buffer_'.
-   *
-   * @return The formatted string.
-   */
-  std::string format() const;
 }; // class LogMessage
 
 } // namespace helios::logger
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <string>
 
+#include "log_args.hpp"
+#include "log_level.hpp"
 #include "log_message_factory.hpp"
 
 namespace helios::logger {
@@ -19,6 +23,16 @@ namespace helios::logger {
  *   sinks.
  * - The available sinks could be determined from the file 'log_config.hpp'
  *   which is generated by CMake.
+ * - The *f() functions log deferred messages: only the format string and the
+ *   raw argument bytes are captured, and the text is rendered by the sinks.
+ * - The *Kv() functions log structured messages: a message and typed
+ *   key/value fields, captured like deferred arguments.
+ * - Besides the compile-time floor LOG_LEVEL_MIN, levels are filtered at
+ *   runtime by a global threshold and optional per-name thresholds. The LOG_*
+ *   macros check them through isEnabled() before building any message.
+ * - The messages queued for the sinks are bounded by LOG_QUEUE_CAPACITY. While
+ *   the queue is full, LOG_OVERLOAD_POLICY blocks the caller or drops the
+ *   message, and the drops are reported as a Warning of the name 'logger'.
  *
  * @note
  * - All public functions are synchronous.
@@ -46,11 +60,100 @@ public:
   Logger(Logger &&) = delete;
   Logger &operator=(Logger &&) = delete;
 
+  /**
+   * @brief Returns true if messages of a level are enabled for this logger at
+   *        runtime.
+   *
+   * @param lvl Log level.
+   *
+   * @note
+   * - Costs one relaxed atomic load.
+   */
+  bool isEnabled(LogLevel lvl) const {
+    return static_cast<int>(lvl) >= threshold_->load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Sets the runtime threshold of all the loggers without their own
+   *        threshold.
+   *
+   * @param lvl Minimum enabled level.
+   */
+  static void setLevel(LogLevel lvl);
+
+  /**
+   * @brief Sets the runtime threshold of the loggers with a name.
+   *
+   * @param name Name of the loggers.
+   * @param lvl Minimum enabled level.
+   *
+   * @note
+   * - Applies to the existing loggers and to the ones created later.
+   */
+  static void setLevel(const std::string &name, LogLevel lvl);
+
+  /**
+   * @brief Makes the loggers with a name follow the global threshold again.
+   *
+   * @param name Name of the loggers.
+   */
+  static void resetLevel(const std::string &name);
+
   LogMessageFactory debug();
   LogMessageFactory info();
   LogMessageFactory warn();
   LogMessageFactory error();
 
+  /**
+   * @brief Logs a deferred message.
+   *
+   * @tparam N Size of the format string.
+   * @tparam Args Types of the arguments. Numbers, characters and strings.
+   * @param fmt Format string literal. Each "{}" is replaced by an argument.
+   * @param args Arguments.
+   */
+  template <std::size_t N, typename... Args>
+  void debugf(const char (&fmt)[N], const Args &...args) {
+    logf(LogLevel::Debug, fmt, args...);
+  }
+  template <std::size_t N, typename... Args>
+  void infof(const char (&fmt)[N], const Args &...args) {
+    logf(LogLevel::Info, fmt, args...);
+  }
+  template <std::size_t N, typename... Args>
+  void warnf(const char (&fmt)[N], const Args &...args) {
+    logf(LogLevel::Warning, fmt, args...);
+  }
+  template <std::size_t N, typename... Args>
+  void errorf(const char (&fmt)[N], const Args &...args) {
+    logf(LogLevel::Error, fmt, args...);
+  }
+
+  /**
+   * @brief Logs a structured message.
+   *
+   * @tparam N Size of the message.
+   * @tparam Values Types of the values. Numbers, characters and strings.
+   * @param msg Message string literal.
+   * @param fields Fields created by kv().
+   */
+  template <std::size_t N, typename... Values>
+  void debugKv(const char (&msg)[N], const Field<Values> &...fields) {
+    logKv(LogLevel::Debug, msg, fields...);
+  }
+  template <std::size_t N, typename... Values>
+  void infoKv(const char (&msg)[N], const Field<Values> &...fields) {
+    logKv(LogLevel::Info, msg, fields...);
+  }
+  template <std::size_t N, typename... Values>
+  void warnKv(const char (&msg)[N], const Field<Values> &...fields) {
+    logKv(LogLevel::Warning, msg, fields...);
+  }
+  template <std::size_t N, typename... Values>
+  void errorKv(const char (&msg)[N], const Field<Values> &...fields) {
+    logKv(LogLevel::Error, msg, fields...);
+  }
+
 private:
   /**
    * @brief Forward decleration for the implementation class.
@@ -61,6 +164,39 @@ private:
    * @brief Unique pointer to the implementation class.
    */
   std::unique_ptr<Impl> impl_;
+
+  /**
+   * @brief Runtime threshold of this logger's name.
+   */
+  const std::atomic<int> *threshold_;
+
+  /**
+   * @brief Captures the arguments of a deferred message.
+   */
+  template <typename... Args>
+  void logf(LogLevel lvl, const char *fmt, const Args &...args) {
+    const LogFormat format{fmt, ARG_TYPES<Args...>, sizeof...(Args)};
+    LogArgs packed;
+    (packed.append(args), ...);
+    logDeferred(lvl, format, packed);
+  }
+
+  /**
+   * @brief Captures the fields of a structured message.
+   */
+  template <typename... Values>
+  void logKv(LogLevel lvl, const char *msg, const Field<Values> &...fields) {
+    LogFormat format{msg, ARG_TYPES<Values...>, sizeof...(Values)};
+    format.structured = true;
+    LogArgs packed;
+    (packed.appendField(fields.key, fields.value), ...);
+    logDeferred(lvl, format, packed);
+  }
+
+  /**
+   * @brief Hands a deferred message to the backend.
+   */
+  void logDeferred(LogLevel lvl, const LogFormat &format, const LogArgs &args);
 }; // class Logger
 
 } // namespace helios::logger
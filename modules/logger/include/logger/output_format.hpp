@@ -0,0 +1,13 @@
+#pragma once
+
+namespace helios::logger {
+
+/**
+ * @brief Output format of a text sink.
+ * - Text: '[time] [LEVEL] [tag] message key=value...'
+ * - Json: One JSON object per line.
+ * - Logfmt: One line of 'key=value' pairs.
+ */
+enum class OutputFormat { Text, Json, Logfmt };
+
+} // namespace helios::logger
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace helios::logger {
+
+/**
+ * @brief What a producer does when the queue of log messages is full.
+ * - Block: Waits until the sinks catch up.
+ * - DropNewest: Drops the new message.
+ * - DropByLevel: Drops the new message if its level is above its share of the
+ *   queue. Lower levels get smaller shares, so they are dropped first.
+ */
+enum class OverloadPolicy { Block, DropNewest, DropByLevel };
+
+} // namespace helios::logger
@@ -0,0 +1,428 @@
+#include "binary_format.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+using helios::logger::ArgType;
+
+/**
+ * @brief Appends an unsigned varint.
+ */
+void putVarint(std::uint64_t value, std::string &out) {
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+/**
+ * @brief Appends a signed varint in zigzag encoding.
+ */
+void putSigned(std::int64_t value, std::string &out) {
+  putVarint((static_cast<std::uint64_t>(value) << 1) ^
+                static_cast<std::uint64_t>(value >> 63),
+            out);
+}
+
+/**
+ * @brief Appends a value as little-endian bytes.
+ */
+void putFixed(std::uint64_t value, std::string &out) {
+  for (int i{}; i < 8; ++i)
+    out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+/**
+ * @brief Appends a length-prefixed string.
+ */
+void putString(std::string_view s, std::string &out) {
+  putVarint(s.size(), out);
+  out.append(s.data(), s.size());
+}
+
+/**
+ * @brief Reads a value of type T from the argument bytes of LogArgs.
+ */
+template <typename T> T load(const std::byte *&p) {
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  p += sizeof(T);
+  return value;
+}
+
+/**
+ * @brief Reads the fields of a payload.
+ */
+class Reader {
+public:
+  explicit Reader(std::string_view payload)
+      : p_{payload.data()}, end_{payload.data() + payload.size()} {}
+
+  std::uint64_t varint() {
+    std::uint64_t value{0};
+    for (int shift{}; shift < 64; shift += 7) {
+      const auto byte = static_cast<std::uint8_t>(*take(1));
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return value;
+    }
+    throw std::runtime_error("Corrupted varint");
+  }
+
+  std::int64_t signedVarint() {
+    const std::uint64_t v = varint();
+    return static_cast<std::int64_t>(v >> 1) ^
+           -static_cast<std::int64_t>(v & 1);
+  }
+
+  std::uint64_t fixed() {
+    const char *p = take(8);
+    std::uint64_t value{0};
+    for (int i{}; i < 8; ++i)
+      value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(p[i]))
+               << (8 * i);
+    return value;
+  }
+
+  std::uint8_t byte() { return static_cast<std::uint8_t>(*take(1)); }
+
+  std::string_view string() {
+    const std::uint64_t len = varint();
+    return {take(len), len};
+  }
+
+private:
+  const char *p_;
+  const char *end_;
+
+  const char *take(std::uint64_t n) {
+    if (n > static_cast<std::uint64_t>(end_ - p_))
+      throw std::runtime_error("Truncated record");
+    const char *p = p_;
+    p_ += n;
+    return p;
+  }
+}; // class Reader
+
+/**
+ * @brief Builds the payload of a format record.
+ */
+void putFormat(std::uint64_t id, const helios::logger::LogFormat &format,
+               std::string &payload) {
+  payload.clear();
+  putVarint(id, payload);
+  putVarint(format.count, payload);
+  for (std::size_t i{}; i < format.count; ++i)
+    payload += static_cast<char>(format.types[i]);
+  payload += static_cast<char>(format.structured ? 1 : 0);
+  putString(format.fmt, payload);
+}
+
+/**
+ * @brief Builds the payload of a message record.
+ *
+ * @param format Id of the format. 0 for a streamed message.
+ */
+void putMessage(const helios::logger::LogMessage &msg, std::uint64_t tag,
+                std::uint64_t format, std::string &payload) {
+  payload.clear();
+  payload += static_cast<char>(msg.level);
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      msg.timestamp.time_since_epoch()
+  );
+  putFixed(static_cast<std::uint64_t>(ns.count()), payload);
+  putVarint(tag, payload);
+  putVarint(format, payload);
+
+  if (format == 0) {
+    putString(msg.body, payload);
+    return;
+  }
+  const std::size_t count = std::min(msg.format.count, msg.args.count());
+  putVarint(count, payload);
+  const std::byte *p = msg.args.data();
+  for (std::size_t i{}; i < count; ++i) {
+    if (msg.format.structured) {
+      const auto len = load<std::uint16_t>(p);
+      putString({reinterpret_cast<const char *>(p), len}, payload);
+      p += len;
+    }
+    switch (msg.format.types[i]) {
+    case ArgType::Bool:
+    case ArgType::Char:
+      payload += load<char>(p);
+      break;
+    case ArgType::Int:
+      putSigned(load<std::int64_t>(p), payload);
+      break;
+    case ArgType::UInt:
+      putVarint(load<std::uint64_t>(p), payload);
+      break;
+    case ArgType::Double: {
+      std::uint64_t bits;
+      const double value = load<double>(p);
+      std::memcpy(&bits, &value, sizeof(bits));
+      putFixed(bits, payload);
+      break;
+    }
+    case ArgType::String: {
+      const auto len = load<std::uint16_t>(p);
+      putString({reinterpret_cast<const char *>(p), len}, payload);
+      p += len;
+      break;
+    }
+    }
+  }
+}
+
+/**
+ * @brief Appends a record made of a kind and a payload.
+ */
+void putRecord(helios::logger::binary::RecordKind kind,
+               const std::string &payload, std::string &out) {
+  out += static_cast<char>(kind);
+  putVarint(payload.size(), out);
+  out += payload;
+}
+
+/**
+ * @brief Reads an unsigned varint from a stream.
+ *
+ * @param in Stream.
+ * @param consumed Incremented by the number of bytes read.
+ */
+std::uint64_t readVarint(std::istream &in, std::uint64_t &consumed) {
+  std::uint64_t value{0};
+  for (int shift{}; shift < 64; shift += 7) {
+    const int c = in.get();
+    if (c == std::char_traits<char>::eof())
+      throw std::runtime_error("Truncated record");
+    ++consumed;
+    value |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+    if (!(c & 0x80))
+      return value;
+  }
+  throw std::runtime_error("Corrupted varint");
+}
+
+} // namespace
+
+namespace helios::logger {
+
+void BinaryEncoder::writeHeader(std::string &out) {
+  out.append(binary::MAGIC, sizeof(binary::MAGIC));
+  out += static_cast<char>(binary::VERSION);
+}
+
+void BinaryEncoder::encode(const LogMessage &msg, std::string &out) {
+  static const std::string noTag;
+  const std::uint64_t tag = tagId(msg.tag ? *msg.tag : noTag, out);
+  const std::uint64_t format = msg.format.fmt ? formatId(msg.format, out) : 0;
+  putMessage(msg, tag, format, payload_);
+  putRecord(binary::RecordKind::Message, payload_, out);
+}
+
+std::uint64_t BinaryEncoder::tagId(const std::string &tag, std::string &out) {
+  auto [it, added] = tags_.try_emplace(tag, tags_.size() + 1);
+  if (added)
+    encodeTag(it->second, tag, payload_, out);
+  return it->second;
+}
+
+std::uint64_t BinaryEncoder::formatId(const LogFormat &format,
+                                      std::string &out) {
+  auto [it, added] = formats_.try_emplace(format.fmt, formats_.size() + 1);
+  if (added) {
+    putFormat(it->second, format, payload_);
+    putRecord(binary::RecordKind::Format, payload_, out);
+  }
+  return it->second;
+}
+
+void encodeTag(std::uint64_t id, const std::string &tag, std::string &payload,
+               std::string &out) {
+  payload.clear();
+  putVarint(id, payload);
+  putString(tag, payload);
+  putRecord(binary::RecordKind::Tag, payload, out);
+}
+
+void encodeStandalone(const LogMessage &msg, std::uint64_t tag,
+                      std::string &payload, std::string &out) {
+  std::uint64_t format{0};
+  if (msg.format.fmt) {
+    format = 1;
+    putFormat(format, msg.format, payload);
+    putRecord(binary::RecordKind::Format, payload, out);
+  }
+  putMessage(msg, tag, format, payload);
+  putRecord(binary::RecordKind::Message, payload, out);
+}
+
+BinaryDecoder::BinaryDecoder(std::istream &in, RecordFilter filter)
+    : in_{in}, filter_{std::move(filter)} {
+  char header[sizeof(binary::MAGIC) + 1];
+  if (!in_.read(header, sizeof(header)) ||
+      std::memcmp(header, binary::MAGIC, sizeof(binary::MAGIC)) != 0)
+    throw std::runtime_error("Not a binary log file");
+  if (static_cast<std::uint8_t>(header[sizeof(binary::MAGIC)]) !=
+      binary::VERSION)
+    throw std::runtime_error("Unsupported binary log version");
+}
+
+bool BinaryDecoder::next(LogMessage &msg) {
+  constexpr std::uint64_t HEAD_SIZE{9}; // Level and time stamp
+  while (true) {
+    const int kind = in_.get();
+    if (kind == std::char_traits<char>::eof())
+      return false;
+    std::uint64_t consumed{0};
+    const std::uint64_t len = readVarint(in_, consumed);
+
+    if (kind == static_cast<int>(binary::RecordKind::Message)) {
+      char head[HEAD_SIZE];
+      if (len < HEAD_SIZE || !in_.read(head, HEAD_SIZE))
+        throw std::runtime_error("Truncated record");
+      Reader headReader({head, HEAD_SIZE});
+      const auto lvl = static_cast<LogLevel>(headReader.byte());
+      const std::chrono::system_clock::time_point timestamp{
+          std::chrono::duration_cast<std::chrono::system_clock::duration>(
+              std::chrono::nanoseconds(
+                  static_cast<std::int64_t>(headReader.fixed())
+              )
+          )
+      };
+      if (static_cast<int>(lvl) < static_cast<int>(filter_.minLevel) ||
+          timestamp < filter_.from || timestamp > filter_.to) {
+        in_.ignore(static_cast<std::streamsize>(len - HEAD_SIZE));
+        continue;
+      }
+
+      consumed = 0;
+      const auto tagIt = tags_.find(readVarint(in_, consumed));
+      if (tagIt == tags_.end())
+        throw std::runtime_error("Unknown tag");
+      if (consumed > len - HEAD_SIZE)
+        throw std::runtime_error("Truncated record");
+      const std::uint64_t rest = len - HEAD_SIZE - consumed;
+      if (!acceptsTag(*tagIt->second)) {
+        in_.ignore(static_cast<std::streamsize>(rest));
+        continue;
+      }
+
+      payload_.resize(rest);
+      if (!in_.read(payload_.data(), static_cast<std::streamsize>(rest)))
+        throw std::runtime_error("Truncated record");
+      Reader reader(payload_);
+      msg = LogMessage{};
+      msg.level = lvl;
+      msg.timestamp = timestamp;
+      msg.tag = tagIt->second;
+
+      const std::uint64_t formatId = reader.varint();
+      if (formatId == 0) {
+        msg.body = std::string(reader.string());
+        return true;
+      }
+      const auto formatIt = formats_.find(formatId);
+      if (formatIt == formats_.end())
+        throw std::runtime_error("Unknown format");
+      const Format &format = *formatIt->second;
+      msg.format = {format.fmt.c_str(), format.types.data(),
+                    format.types.size(), format.structured};
+      const std::uint64_t count = reader.varint();
+      for (std::uint64_t i{}; i < count && i < format.types.size(); ++i) {
+        std::string_view key;
+        if (format.structured)
+          key = reader.string();
+        const auto add = [&msg, &format, key](const auto &value) {
+          if (format.structured)
+            msg.args.appendField(key, value);
+          else
+            msg.args.append(value);
+        };
+        switch (format.types[i]) {
+        case ArgType::Bool:
+          add(reader.byte() != 0);
+          break;
+        case ArgType::Char:
+          add(static_cast<char>(reader.byte()));
+          break;
+        case ArgType::Int:
+          add(reader.signedVarint());
+          break;
+        case ArgType::UInt:
+          add(reader.varint());
+          break;
+        case ArgType::Double: {
+          const std::uint64_t bits = reader.fixed();
+          double value;
+          std::memcpy(&value, &bits, sizeof(value));
+          add(value);
+          break;
+        }
+        case ArgType::String:
+          add(reader.string());
+          break;
+        }
+      }
+      return true;
+    }
+
+    payload_.resize(len);
+    if (!in_.read(payload_.data(), static_cast<std::streamsize>(len)))
+      throw std::runtime_error("Truncated record");
+    Reader reader(payload_);
+    if (kind == static_cast<int>(binary::RecordKind::Tag)) {
+      const std::uint64_t id = reader.varint();
+      tags_[id] = std::make_shared<const std::string>(reader.string());
+    } else if (kind == static_cast<int>(binary::RecordKind::Format)) {
+      const std::uint64_t id = reader.varint();
+      auto format = std::make_unique<Format>();
+      const std::uint64_t count = reader.varint();
+      for (std::uint64_t i{}; i < count; ++i)
+        format->types.push_back(static_cast<ArgType>(reader.byte()));
+      format->structured = (reader.byte() & 1) != 0;
+      format->fmt = std::string(reader.string());
+      formats_[id] = std::move(format);
+    }
+    // Unknown kinds are skipped for forward compatibility
+  }
+}
+
+std::uint64_t completeLength(std::istream &in) {
+  char header[sizeof(binary::MAGIC) + 1];
+  if (!in.read(header, sizeof(header)) ||
+      std::memcmp(header, binary::MAGIC, sizeof(binary::MAGIC)) != 0 ||
+      static_cast<std::uint8_t>(header[sizeof(binary::MAGIC)]) !=
+          binary::VERSION)
+    return 0;
+  std::uint64_t length{sizeof(header)};
+  while (in.get() != std::char_traits<char>::eof()) {
+    std::uint64_t consumed{1}; // Kind
+    std::uint64_t len;
+    try {
+      len = readVarint(in, consumed);
+    } catch (const std::runtime_error &) {
+      break; // Truncated length
+    }
+    in.ignore(static_cast<std::streamsize>(len));
+    if (static_cast<std::uint64_t>(in.gcount()) < len)
+      break; // Truncated payload
+    length += consumed + len;
+  }
+  return length;
+}
+
+bool BinaryDecoder::acceptsTag(const std::string &tag) const {
+  return filter_.tags.empty() ||
+         std::find(filter_.tags.begin(), filter_.tags.end(), tag) !=
+             filter_.tags.end();
+}
+
+} // namespace helios::logger
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "log_message.hpp"
+
+namespace helios::logger {
+
+/**
+ * @brief Layout of the binary log files.
+ *
+ * @details
+ * - A file starts with the 4 bytes 'HLOG' and a version byte.
+ * - Then follows a sequence of records: a kind byte, a varint payload length
+ *   and the payload. The length allows skipping records without decoding.
+ * - Tag and format records define dictionary entries before the messages that
+ *   use them, so every file decodes on its own.
+ * - A message payload starts with the level byte and the time stamp as 8 bytes
+ *   of nanoseconds since the epoch, so it can be filtered before the rest is
+ *   read. Then follow the varint tag id and the varint format id. Format id 0
+ *   marks a streamed message followed by its body, other ids are followed by
+ *   the argument count and the arguments. The arguments of a structured
+ *   message are fields, each a key string followed by the value.
+ * - A format record holds the id, the argument types, a flags byte (bit 0:
+ *   structured) and the format string.
+ * - Integers are varints (zigzag for signed ones), doubles are 8 raw bytes and
+ *   strings are a varint length followed by the bytes. Fixed-size values are
+ *   stored in little-endian order.
+ */
+namespace binary {
+
+/**
+ * @brief Magic bytes at the start of a file.
+ */
+inline constexpr char MAGIC[4] = {'H', 'L', 'O', 'G'};
+
+/**
+ * @brief Version of the layout.
+ */
+inline constexpr std::uint8_t VERSION = 3;
+
+/**
+ * @brief Kinds of records.
+ */
+enum class RecordKind : std::uint8_t { Tag = 1, Format = 2, Message = 3 };
+
+} // namespace binary
+
+/**
+ * @class logger::BinaryEncoder
+ *
+ * @brief Encodes log messages into binary records.
+ *
+ * @details
+ * - Keeps the dictionaries of the tags and the formats written so far and
+ *   emits their records the first time they are used.
+ *
+ * @note
+ * - Not thread-safe. Used by one sink only.
+ */
+class BinaryEncoder {
+public:
+  /**
+   * @brief Appends the file header.
+   *
+   * @param out Buffer to append to.
+   */
+  static void writeHeader(std::string &out);
+
+  /**
+   * @brief Appends a message record and the dictionary records it needs.
+   *
+   * @param msg Log message.
+   * @param out Buffer to append to.
+   */
+  void encode(const LogMessage &msg, std::string &out);
+
+private:
+  /**
+   * @brief Ids of the written tags.
+   */
+  std::unordered_map<std::string, std::uint64_t> tags_;
+
+  /**
+   * @brief Ids of the written formats, keyed by their string literal.
+   */
+  std::unordered_map<const char *, std::uint64_t> formats_;
+
+  /**
+   * @brief Payload being built. Reused between records.
+   */
+  std::string payload_;
+
+  /**
+   * @brief Returns the id of a tag and appends its record if it is new.
+   */
+  std::uint64_t tagId(const std::string &tag, std::string &out);
+
+  /**
+   * @brief Returns the id of a format and appends its record if it is new.
+   */
+  std::uint64_t formatId(const LogFormat &format, std::string &out);
+}; // class BinaryEncoder
+
+/**
+ * @brief Appends the record of a tag.
+ *
+ * @param id Id of the tag.
+ * @param tag Name of the tag.
+ * @param payload Buffer for the payload. Reused between calls.
+ * @param out Buffer to append to.
+ */
+void encodeTag(std::uint64_t id, const std::string &tag, std::string &payload,
+               std::string &out);
+
+/**
+ * @brief Appends the records of a message that decode without any other
+ *        record than the one of its tag.
+ *
+ * @details
+ * - A deferred message is preceded by the record of its format, with id 1.
+ * - Used by the memory-mapped sink, whose slots are decoded one by one.
+ *
+ * @param msg Log message.
+ * @param tag Id of the tag of the message.
+ * @param payload Buffer for the payloads. Reused between calls.
+ * @param out Buffer to append to.
+ */
+void encodeStandalone(const LogMessage &msg, std::uint64_t tag,
+                      std::string &payload, std::string &out);
+
+/**
+ * @brief Selects the messages returned by a BinaryDecoder.
+ */
+struct RecordFilter {
+  /**
+   * @brief Earliest time stamp.
+   */
+  std::chrono::system_clock::time_point from{
+      std::chrono::system_clock::time_point::min()
+  };
+
+  /**
+   * @brief Latest time stamp.
+   */
+  std::chrono::system_clock::time_point to{
+      std::chrono::system_clock::time_point::max()
+  };
+
+  /**
+   * @brief Minimum level.
+   */
+  LogLevel minLevel{LogLevel::Debug};
+
+  /**
+   * @brief Accepted tags. Empty accepts all.
+   */
+  std::vector<std::string> tags;
+}; // struct RecordFilter
+
+/**
+ * @class logger::BinaryDecoder
+ *
+ * @brief Decodes binary records back into log messages.
+ *
+ * @details
+ * - Messages rejected by the filter are skipped by their length after reading
+ *   at most their level, time stamp and tag.
+ * - Decoded messages render with formatText() exactly like the original ones.
+ *
+ * @note
+ * - Decoded messages point into the dictionaries of the decoder, so they
+ *   shall not outlive it.
+ * - Not thread-safe.
+ */
+class BinaryDecoder {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param in Stream of a binary log file.
+   * @param filter Selects the returned messages.
+   *
+   * @throws std::runtime_error if the stream is not a binary log file.
+   */
+  BinaryDecoder(std::istream &in, RecordFilter filter = {});
+
+  /**
+   * @brief Reads the next message accepted by the filter.
+   *
+   * @param msg Decoded message.
+   *
+   * @return False at the end of the stream.
+   *
+   * @throws std::runtime_error if a record is corrupted.
+   */
+  bool next(LogMessage &msg);
+
+private:
+  /**
+   * @brief Format of the dictionary.
+   */
+  struct Format {
+    std::string fmt;
+    std::vector<ArgType> types;
+    bool structured;
+  }; // struct Format
+
+  /**
+   * @brief Stream of the file.
+   */
+  std::istream &in_;
+
+  /**
+   * @brief Selects the returned messages.
+   */
+  const RecordFilter filter_;
+
+  /**
+   * @brief Tags by id.
+   */
+  std::unordered_map<std::uint64_t, std::shared_ptr<const std::string>> tags_;
+
+  /**
+   * @brief Formats by id. Owned here since decoded messages point to them.
+   */
+  std::unordered_map<std::uint64_t, std::unique_ptr<Format>> formats_;
+
+  /**
+   * @brief Payload being decoded. Reused between records.
+   */
+  std::string payload_;
+
+  /**
+   * @brief Returns true if the filter accepts a tag.
+   */
+  bool acceptsTag(const std::string &tag) const;
+}; // class BinaryDecoder
+
+/**
+ * @brief Returns the length of the header and the complete records at the
+ *        start of a binary log file.
+ *
+ * @details
+ * - A crash may leave the last record truncated. Records appended after it
+ *   would all be misparsed, so the sink cuts the file to this length before
+ *   appending.
+ *
+ * @param in Stream of the file.
+ *
+ * @return 0 if the stream does not start with a valid header.
+ */
+std::uint64_t completeLength(std::istream &in);
+
+} // namespace helios::logger
@@ -0,0 +1,69 @@
+#include "binary_sink.hpp"
+
+#include <fstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "log_message.hpp"
+
+namespace helios::logger {
+
+BinarySink::BinarySink(
+    std::shared_ptr<core::HLoop> loop, std::shared_ptr<core::HBus> hBus,
+    const std::string &filePath, FlushPolicy policy
+)
+    : InActiveHObject{loop, hBus}, continued_{prepareFile(filePath)},
+      writer_{openLogFile(filePath), true, policy} {
+  // A continued file already has a header. The dictionaries are written
+  // again on first use, so the appended records decode on their own.
+  if (!continued_) {
+    BinaryEncoder::writeHeader(records_);
+    writer_.append(records_, LogLevel::Debug);
+  }
+  LISTEN(LogMessage, {
+    records_.clear();
+    encoder_.encode(*sig, records_);
+    writer_.append(records_, sig->level);
+  });
+  if (writer_.interval().count() > 0)
+    scheduleFlush();
+}
+
+BinarySink::~BinarySink() {
+  cancelTimers(); // The flush timer uses the writer
+  drain();
+}
+
+bool BinarySink::prepareFile(const std::string &filePath) {
+  struct stat st {};
+  if (::stat(filePath.c_str(), &st) != 0 || st.st_size == 0)
+    return false;
+  std::uint64_t complete;
+  {
+    std::ifstream in(filePath, std::ios::binary);
+    complete = completeLength(in);
+  }
+  if (complete == 0) {
+    // Another format or version, kept for the tools that read it
+    moveAside(filePath);
+    return false;
+  }
+  if (complete < static_cast<std::uint64_t>(st.st_size)) {
+    // Drops a record left truncated by a crash
+    if (::truncate(filePath.c_str(), static_cast<off_t>(complete)) != 0) {
+      moveAside(filePath); // Rotated rather than continued after the tear
+      return false;
+    }
+  }
+  return true;
+}
+
+void BinarySink::scheduleFlush() {
+  postAfter(writer_.interval(), [this] {
+    writer_.flush();
+    scheduleFlush();
+  });
+}
+
+} // namespace helios::logger
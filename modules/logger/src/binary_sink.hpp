@@ -0,0 +1,93 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <core/h_loop.hpp>
+#include <core/in_active_h_object.hpp>
+
+#include "binary_format.hpp"
+#include "buffered_writer.hpp"
+
+namespace helios::logger {
+
+/**
+ * @class logger::BinarySink
+ *
+ * @brief Takes a message and appends it to a given file in the compact binary
+ *        format.
+ *
+ * @details
+ * - Deferred messages are stored as their format id and their arguments, so
+ *   the text is never rendered while logging.
+ * - The files are turned back into text by the 'helios-logdecode' tool.
+ * - An existing file of the same version is continued, cut after its last
+ *   complete record. Another file at the path, e.g. of an older version, is
+ *   moved aside with moveAside() and a new file is started.
+ * - Records are written in batches according to the flush policy. The
+ *   interval flushes run on the loop.
+ */
+class BinarySink : public core::InActiveHObject {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param hBus Bus used for log messages.
+   * @param filePath Path of the file used for logging.
+   * @param policy Flush policy.
+   */
+  BinarySink(
+      std::shared_ptr<core::HLoop> loop, std::shared_ptr<core::HBus> hBus,
+      const std::string &filePath, FlushPolicy policy = {}
+  );
+
+  /**
+   * @brief Virtual destructor.
+   *
+   * @note
+   * - Blocks until the queued messages are written.
+   */
+  ~BinarySink() override;
+
+private:
+  /**
+   * @brief True if the file existed with a header.
+   */
+  const bool continued_;
+
+  /**
+   * @brief Buffered writer of the file.
+   */
+  BufferedWriter writer_;
+
+  /**
+   * @brief Encodes the messages.
+   */
+  BinaryEncoder encoder_;
+
+  /**
+   * @brief Encoded records of one message. Reused between messages.
+   */
+  std::string records_;
+
+  /**
+   * @brief Prepares an existing file to be continued before it is opened.
+   *
+   * @details
+   * - Cuts a record left truncated by a crash. A file that can't be cut or
+   *   that has another format or version is moved aside.
+   *
+   * @param filePath Path of the file.
+   *
+   * @return True if the file is continued, false if a new one is started.
+   */
+  static bool prepareFile(const std::string &filePath);
+
+  /**
+   * @brief Flushes the writer after an interval of the flush policy and
+   *        schedules the next flush.
+   */
+  void scheduleFlush();
+}; // class BinarySink
+
+} // namespace helios::logger
@@ -0,0 +1,122 @@
+#include "buffered_writer.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/uio.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Writes all the given buffers, continuing after partial writes.
+ *
+ * @param fd File descriptor.
+ * @param iov Buffers. Modified while writing.
+ * @param count Number of buffers.
+ */
+void writeAll(int fd, iovec *iov, int count) {
+  while (count > 0) {
+    const ssize_t n = ::writev(fd, iov, count);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return; // Nothing sensible to do, the text is dropped
+    }
+    auto left = static_cast<std::size_t>(n);
+    while (count > 0 && left >= iov->iov_len) {
+      left -= iov->iov_len;
+      ++iov;
+      --count;
+    }
+    if (count > 0) {
+      iov->iov_base = static_cast<char *>(iov->iov_base) + left;
+      iov->iov_len -= left;
+    }
+  }
+}
+
+} // namespace
+
+namespace helios::logger {
+
+int openLogFile(const std::string &filePath) {
+  const auto dir = std::filesystem::path(filePath).parent_path();
+  if (!dir.empty()) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+  }
+  return ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                0644);
+}
+
+bool moveAside(const std::string &filePath) {
+  const std::time_t now = std::time(nullptr);
+  std::tm tm{};
+  localtime_r(&now, &tm);
+  char stamp[32];
+  std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+  std::string aside = filePath + '.' + stamp + ".old";
+  std::error_code ec;
+  for (int n{1}; std::filesystem::exists(aside, ec); ++n)
+    aside = filePath + '.' + stamp + '.' + std::to_string(n) + ".old";
+  return std::rename(filePath.c_str(), aside.c_str()) == 0;
+}
+
+BufferedWriter::BufferedWriter(int fd, bool ownsFd, FlushPolicy policy)
+    : fd_{fd}, ownsFd_{ownsFd}, policy_{policy} {
+  buffer_.reserve(policy_.bufferSize);
+}
+
+BufferedWriter::~BufferedWriter() {
+  flush();
+  if (ownsFd_ && fd_ >= 0)
+    ::close(fd_);
+}
+
+void BufferedWriter::append(const std::string &text, LogLevel lvl) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  ++pending_;
+  if (buffer_.size() + text.size() > policy_.bufferSize) {
+    writeLocked(text);
+    return;
+  }
+  buffer_ += text;
+  if ((policy_.everyMessages > 0 && pending_ >= policy_.everyMessages) ||
+      static_cast<int>(lvl) >= static_cast<int>(policy_.flushLevel))
+    writeLocked();
+}
+
+void BufferedWriter::flush() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (!buffer_.empty())
+    writeLocked();
+}
+
+void BufferedWriter::reset(int fd) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (!buffer_.empty())
+    writeLocked();
+  if (ownsFd_ && fd_ >= 0)
+    ::close(fd_);
+  fd_ = fd;
+}
+
+void BufferedWriter::writeLocked(const std::string &extra) {
+  if (fd_ >= 0) {
+    iovec iov[2]{
+        {buffer_.data(), buffer_.size()},
+        {const_cast<char *>(extra.data()), extra.size()},
+    };
+    writeAll(fd_, iov, extra.empty() ? 1 : 2);
+    if (policy_.fsync)
+      ::fsync(fd_);
+  }
+  buffer_.clear();
+  pending_ = 0;
+}
+
+} // namespace helios::logger
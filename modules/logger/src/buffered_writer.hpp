@@ -0,0 +1,175 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+#include "log_config.hpp"
+#include "logger/log_level.hpp"
+
+namespace helios::logger {
+
+/**
+ * @brief Decides when a BufferedWriter writes its buffer.
+ *
+ * @details
+ * - The defaults are taken from 'log_config.hpp' which is generated by CMake.
+ */
+struct FlushPolicy {
+  /**
+   * @brief Size of the buffer in bytes. A full buffer is always written.
+   */
+  std::size_t bufferSize{LOG_BUFFER_SIZE};
+
+  /**
+   * @brief Writes after this many buffered messages. 0 disables it.
+   */
+  std::size_t everyMessages{LOG_FLUSH_EVERY};
+
+  /**
+   * @brief Writes the buffered messages at least this often. 0 disables it.
+   *        Driven by the owner of the writer calling flush().
+   */
+  std::chrono::milliseconds interval{LOG_FLUSH_INTERVAL_MS};
+
+  /**
+   * @brief Writes as soon as a message of this level or higher is buffered.
+   */
+  LogLevel flushLevel{LOG_FLUSH_LEVEL};
+
+  /**
+   * @brief Calls fsync() after every write.
+   */
+  bool fsync{ENABLE_FSYNC};
+}; // struct FlushPolicy
+
+/**
+ * @brief Opens a file for appending and creates its directory if needed.
+ *
+ * @param filePath Path of the file.
+ *
+ * @return File descriptor. Negative if the file could not be opened.
+ */
+int openLogFile(const std::string &filePath);
+
+/**
+ * @brief Renames a file that can't be continued out of the way, to
+ *        '<file>.<YYYYmmdd-HHMMSS>.old' or '<file>.<YYYYmmdd-HHMMSS>.<N>.old'
+ *        if that name is taken.
+ *
+ * @param filePath Path of the file.
+ *
+ * @return False if the file could not be renamed.
+ */
+bool moveAside(const std::string &filePath);
+
+/**
+ * @class logger::BufferedWriter
+ *
+ * @brief Collects text into a buffer and writes it to a file descriptor with
+ *        one system call per batch.
+ *
+ * @details
+ * - The buffer is written according to the FlushPolicy.
+ * - A message larger than the free space is written together with the buffer
+ *   by one writev().
+ * - It has no thread. If an interval is set, the owner calls flush() at
+ *   every interval, e.g. a sink from the delayed events of its loop.
+ * - During destruction, the buffered text is written.
+ *
+ * @note
+ * - All public functions are thread-safe.
+ */
+class BufferedWriter {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param fd File descriptor to write to. Negative values discard the text.
+   * @param ownsFd True if the file descriptor shall be closed by this object.
+   * @param policy Flush policy.
+   */
+  BufferedWriter(int fd, bool ownsFd, FlushPolicy policy = {});
+
+  /**
+   * @brief Destructor.
+   */
+  ~BufferedWriter();
+
+  /**
+   * @brief Delete copy and move semantics.
+   */
+  BufferedWriter(const BufferedWriter &) = delete;
+  BufferedWriter &operator=(const BufferedWriter &) = delete;
+  BufferedWriter(BufferedWriter &&) = delete;
+  BufferedWriter &operator=(BufferedWriter &&) = delete;
+
+  /**
+   * @brief Buffers a message.
+   *
+   * @param text Rendered message.
+   * @param lvl Level of the message.
+   */
+  void append(const std::string &text, LogLevel lvl);
+
+  /**
+   * @brief Writes the buffered text.
+   */
+  void flush();
+
+  /**
+   * @brief Writes the buffered text and switches to another file descriptor.
+   *
+   * @param fd New file descriptor. The old one is closed if owned.
+   */
+  void reset(int fd);
+
+  /**
+   * @brief Returns the interval of the flushes by time. 0 if disabled.
+   */
+  std::chrono::milliseconds interval() const { return policy_.interval; }
+
+private:
+  /**
+   * @brief File descriptor.
+   */
+  int fd_;
+
+  /**
+   * @brief True if the file descriptor is closed by this object.
+   */
+  const bool ownsFd_;
+
+  /**
+   * @brief Flush policy.
+   */
+  const FlushPolicy policy_;
+
+  /**
+   * @brief Buffered text.
+   */
+  std::string buffer_;
+
+  /**
+   * @brief Number of buffered messages.
+   */
+  std::size_t pending_{0};
+
+  /**
+   * @brief Protects this class.
+   */
+  std::mutex mtx_;
+
+  /**
+   * @brief Writes the buffer followed by an optional extra text.
+   *
+   * @param extra Text written after the buffer. May be empty.
+   *
+   * @note
+   * - Shall be called while holding 'mtx_'.
+   */
+  void writeLocked(const std::string &extra = {});
+}; // class BufferedWriter
+
+} // namespace helios::logger
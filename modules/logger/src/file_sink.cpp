@@ -1,20 +1,24 @@
 #include "file_sink.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "log_formatter.hpp"
 #include "log_message.hpp"
 
 namespace {
 
 /**
- * @brief Writes a string to a file.
- *
- * @param s String to be written.
- * @param file File to be written.
+ * @brief Returns the size of an open file. 0 if unknown.
  */
-void write(const std::string &s, std::ofstream &file) {
-  if (file.is_open()) {
-    file << s;
-    file.flush();
-  }
+std::size_t sizeOf(int fd) {
+  struct stat st {};
+  if (fd < 0 || ::fstat(fd, &st) != 0)
+    return 0;
+  return static_cast<std::size_t>(st.st_size);
 }
 
 } // namespace
@@ -23,10 +27,88 @@ namespace helios::logger {
 
 FileSink::FileSink(
     std::shared_ptr<core::HLoop> loop, std::shared_ptr<core::HBus> hBus,
-    const std::string &filePath
+    const std::string &filePath, FlushPolicy policy, RotationPolicy rotation,
+    OutputFormat format
 )
-    : InActiveHObject{loop, hBus}, file_{filePath} {
-  LISTEN(LogMessage, { write(sig->msg, file_); });
+    : InActiveHObject{loop, hBus}, filePath_{filePath}, rotation_{rotation},
+      format_{format}, writer_{openLogFile(filePath), true, policy} {
+  if (rotation_.enabled()) {
+    archiver_ = std::make_unique<LogArchiver>(filePath_, rotation_);
+    const int fd = ::open(filePath_.c_str(), O_RDONLY | O_CLOEXEC);
+    size_ = sizeOf(fd);
+    if (fd >= 0)
+      ::close(fd);
+    nextRotation_ = nextRotation(std::chrono::system_clock::now());
+    if (rotation_.interval.count() > 0)
+      scheduleRotation();
+  }
+  LISTEN(LogMessage, { write(*sig); });
+  if (writer_.interval().count() > 0)
+    scheduleFlush();
+}
+
+FileSink::~FileSink() {
+  cancelTimers(); // The flush and rotation timers use the writer
+  drain();
+}
+
+void FileSink::write(const LogMessage &msg) {
+  std::string text = formatMessage(msg, format_);
+  if (rotation_.enabled()) {
+    const auto now = std::chrono::system_clock::now();
+    const bool full = rotation_.maxSize > 0 && size_ > 0 &&
+                      size_ + text.size() > rotation_.maxSize;
+    const bool due = rotation_.interval.count() > 0 && now >= nextRotation_;
+    if (full || due)
+      rotate(now);
+    size_ += text.size();
+  }
+  writer_.append(text, msg.level);
+}
+
+void FileSink::rotate(std::chrono::system_clock::time_point now) {
+  std::string rotated = archiver_->rotatedPath(now);
+  // The buffered text still goes to the renamed file before switching
+  if (std::rename(filePath_.c_str(), rotated.c_str()) == 0) {
+    writer_.reset(openLogFile(filePath_));
+    archiver_->archive(std::move(rotated));
+  }
+  size_ = 0;
+  nextRotation_ = nextRotation(now);
+}
+
+std::chrono::system_clock::time_point
+FileSink::nextRotation(std::chrono::system_clock::time_point now) const {
+  using namespace std::chrono;
+  if (rotation_.interval.count() == 0)
+    return system_clock::time_point::max();
+  // Aligned to multiples of the interval since the epoch
+  const auto periods = floor<seconds>(now.time_since_epoch()) /
+                       rotation_.interval;
+  return system_clock::time_point((periods + 1) * rotation_.interval);
+}
+
+void FileSink::scheduleFlush() {
+  postAfter(writer_.interval(), [this] {
+    writer_.flush();
+    scheduleFlush();
+  });
+}
+
+void FileSink::scheduleRotation() {
+  const auto left = nextRotation_ - std::chrono::system_clock::now();
+  postAfter(std::max(std::chrono::duration_cast<core::Clock::Duration>(left),
+                     core::Clock::Duration::zero()),
+            [this] {
+              const auto now = std::chrono::system_clock::now();
+              if (now >= nextRotation_) {
+                if (size_ > 0)
+                  rotate(now);
+                else
+                  nextRotation_ = nextRotation(now);
+              }
+              scheduleRotation();
+            });
 }
 
 } // namespace helios::logger
@@ -1,12 +1,21 @@
 #pragma once
 
-#include <fstream>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
 
 #include <core/h_loop.hpp>
 #include <core/in_active_h_object.hpp>
 
+#include "buffered_writer.hpp"
+#include "log_archiver.hpp"
+#include "log_config.hpp"
+
 namespace helios::logger {
 
+struct LogMessage;
+
 /**
  * @class logger::FileSink
  *
@@ -14,6 +23,15 @@ namespace helios::logger {
  *
  * @details
  * - Does not make any modifications to the message, not even adding a new line.
+ * - Messages are appended to the file in batches according to the flush
+ *   policy. The interval flushes run on the loop.
+ * - The directory of the file is created if it does not exist.
+ * - Messages are rendered in the given output format.
+ * - The file is rotated by size and by time according to the rotation policy.
+ *   Rotation by time is also checked by a delayed event on the loop, so an
+ *   idle sink rotates on time as well. An empty file is not rotated.
+ *   Rotated files are compressed and pruned by a LogArchiver in its own
+ *   thread, never in the loop of the sink.
  */
 class FileSink : public core::InActiveHObject {
 public:
@@ -22,22 +40,92 @@ public:
    *
    * @param hBus Bus used for log messages.
    * @param filePath Path of the file used for logging.
+   * @param policy Flush policy.
+   * @param rotation Rotation policy.
+   * @param format Output format.
    */
   FileSink(
       std::shared_ptr<core::HLoop> loop, std::shared_ptr<core::HBus> hBus,
-      const std::string &filePath
+      const std::string &filePath, FlushPolicy policy = {},
+      RotationPolicy rotation = {}, OutputFormat format = LOG_FILE_FORMAT
   );
 
   /**
-   * @brief Default virtual destructor.
+   * @brief Virtual destructor.
+   *
+   * @note
+   * - Blocks until the queued messages are written.
    */
-  ~FileSink() override = default;
+  ~FileSink() override;
 
 private:
   /**
-   * @brief File stream.
+   * @brief Path of the file used for logging.
+   */
+  const std::string filePath_;
+
+  /**
+   * @brief Rotation policy.
+   */
+  const RotationPolicy rotation_;
+
+  /**
+   * @brief Output format.
+   */
+  const OutputFormat format_;
+
+  /**
+   * @brief Archives the rotated files. Only created if rotation is enabled.
+   */
+  std::unique_ptr<LogArchiver> archiver_;
+
+  /**
+   * @brief Buffered writer of the file.
+   */
+  BufferedWriter writer_;
+
+  /**
+   * @brief Size of the current file including the buffered text.
+   */
+  std::size_t size_{0};
+
+  /**
+   * @brief Time of the next rotation by time.
+   */
+  std::chrono::system_clock::time_point nextRotation_;
+
+  /**
+   * @brief Writes a message and rotates the file before if needed.
+   *
+   * @param msg Log message.
+   */
+  void write(const LogMessage &msg);
+
+  /**
+   * @brief Renames the current file, opens a new one and hands the old one to
+   *        the archiver.
+   *
+   * @param now Time of the rotation.
+   */
+  void rotate(std::chrono::system_clock::time_point now);
+
+  /**
+   * @brief Computes the next rotation by time after a given time.
+   */
+  std::chrono::system_clock::time_point
+  nextRotation(std::chrono::system_clock::time_point now) const;
+
+  /**
+   * @brief Flushes the writer after an interval of the flush policy and
+   *        schedules the next flush.
+   */
+  void scheduleFlush();
+
+  /**
+   * @brief Rotates the file at the next rotation by time, unless messages
+   *        did already, and schedules the next check.
    */
-  std::ofstream file_;
+  void scheduleRotation();
 }; // class FileSink
 
 } // namespace helios::logger
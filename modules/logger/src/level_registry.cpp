@@ -0,0 +1,51 @@
+#include "level_registry.hpp"
+
+#include "log_config.hpp"
+
+namespace helios::logger {
+
+LevelRegistry &LevelRegistry::instance() {
+  static LevelRegistry *registry{new LevelRegistry()};
+  return *registry;
+}
+
+LevelRegistry::LevelRegistry() : global_{static_cast<int>(LOG_LEVEL_MIN)} {}
+
+const std::atomic<int> *LevelRegistry::threshold(const std::string &name) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return &entry(name).threshold;
+}
+
+void LevelRegistry::setGlobal(LogLevel lvl) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  global_ = static_cast<int>(lvl);
+  for (auto &[name, e] : entries_) {
+    if (!e->overridden)
+      e->threshold.store(global_, std::memory_order_relaxed);
+  }
+}
+
+void LevelRegistry::set(const std::string &name, LogLevel lvl) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  Entry &e = entry(name);
+  e.overridden = true;
+  e.threshold.store(static_cast<int>(lvl), std::memory_order_relaxed);
+}
+
+void LevelRegistry::clear(const std::string &name) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  Entry &e = entry(name);
+  e.overridden = false;
+  e.threshold.store(global_, std::memory_order_relaxed);
+}
+
+LevelRegistry::Entry &LevelRegistry::entry(const std::string &name) {
+  auto &e = entries_[name];
+  if (!e) {
+    e = std::make_unique<Entry>();
+    e->threshold.store(global_, std::memory_order_relaxed);
+  }
+  return *e;
+}
+
+} // namespace helios::logger
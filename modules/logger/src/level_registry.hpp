@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "logger/log_level.hpp"
+
+namespace helios::logger {
+
+/**
+ * @class logger::LevelRegistry
+ *
+ * @brief Holds the runtime log level thresholds.
+ *
+ * @details
+ * - There is one global threshold and an optional override for each logger
+ *   name.
+ * - Each name owns an atomic threshold that already combines the global
+ *   threshold and its override, so a logger checks a level with one load.
+ * - Thresholds are never removed, so the pointers returned by threshold() stay
+ *   valid for the whole program.
+ *
+ * @note
+ * - All public functions are thread-safe.
+ */
+class LevelRegistry {
+public:
+  /**
+   * @brief Returns the shared instance.
+   *
+   * @note
+   * - The instance is never destroyed so that static loggers can use it
+   *   during program termination.
+   */
+  static LevelRegistry &instance();
+
+  /**
+   * @brief Returns the effective threshold of a logger name.
+   *
+   * @param name Name of the logger.
+   *
+   * @return Pointer to the threshold. Valid for the whole program.
+   */
+  const std::atomic<int> *threshold(const std::string &name);
+
+  /**
+   * @brief Sets the global threshold.
+   *
+   * @param lvl Minimum enabled level for all names without an override.
+   */
+  void setGlobal(LogLevel lvl);
+
+  /**
+   * @brief Overrides the threshold of a logger name.
+   *
+   * @param name Name of the logger.
+   * @param lvl Minimum enabled level for this name.
+   */
+  void set(const std::string &name, LogLevel lvl);
+
+  /**
+   * @brief Removes the override of a logger name so it follows the global
+   *        threshold again.
+   *
+   * @param name Name of the logger.
+   */
+  void clear(const std::string &name);
+
+private:
+  /**
+   * @brief Threshold of one logger name.
+   */
+  struct Entry {
+    /**
+     * @brief Effective minimum enabled level.
+     */
+    std::atomic<int> threshold{0};
+
+    /**
+     * @brief True if the threshold is set for this name only.
+     */
+    bool overridden{false};
+  }; // struct Entry
+
+  /**
+   * @brief Constructor.
+   */
+  LevelRegistry();
+
+  /**
+   * @brief Returns the entry of a name. Creates it if needed.
+   *
+   * @note
+   * - Shall be called while holding 'mtx_'.
+   */
+  Entry &entry(const std::string &name);
+
+  /**
+   * @brief Protects this class.
+   */
+  std::mutex mtx_;
+
+  /**
+   * @brief Global threshold.
+   */
+  int global_;
+
+  /**
+   * @brief Entries by logger name.
+   */
+  std::unordered_map<std::string, std::unique_ptr<Entry>> entries_;
+}; // class LevelRegistry
+
+} // namespace helios::logger
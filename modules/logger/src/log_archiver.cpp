@@ -0,0 +1,118 @@
+#include "log_archiver.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#if LOG_ROTATE_COMPRESS
+#include <zlib.h>
+#endif
+
+namespace {
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Compresses a file to '<path>.gz' and removes it.
+ *
+ * @param path Path of the file.
+ *
+ * @note
+ * - The original file is kept if the compression fails.
+ */
+void compress(const std::string &path) {
+#if LOG_ROTATE_COMPRESS
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open())
+    return;
+  const std::string gzPath = path + ".gz";
+  gzFile out = gzopen(gzPath.c_str(), "wb");
+  if (!out)
+    return;
+  char buf[64 * 1024];
+  bool ok{true};
+  while (ok && in) {
+    in.read(buf, sizeof(buf));
+    const auto n = static_cast<unsigned>(in.gcount());
+    if (n > 0)
+      ok = gzwrite(out, buf, n) == static_cast<int>(n);
+  }
+  ok = gzclose(out) == Z_OK && ok;
+  std::error_code ec;
+  fs::remove(ok ? fs::path(path) : fs::path(gzPath), ec);
+#else
+  (void)path;
+#endif
+}
+
+} // namespace
+
+namespace helios::logger {
+
+LogArchiver::LogArchiver(std::string filePath, RotationPolicy policy)
+    : filePath_{std::move(filePath)}, policy_{policy} {}
+
+LogArchiver::~LogArchiver() { drain(); }
+
+std::string
+LogArchiver::rotatedPath(std::chrono::system_clock::time_point now) const {
+  const std::time_t t = std::chrono::system_clock::to_time_t(now);
+  std::tm tm{};
+  localtime_r(&t, &tm);
+  char stamp[32];
+  std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+
+  // The counter is zero-padded so that the names keep sorting by age
+  for (int n{};; ++n) {
+    char suffix[48];
+    std::snprintf(suffix, sizeof(suffix), ".%s.%03d", stamp, n);
+    const std::string path = filePath_ + suffix;
+    std::error_code ec;
+    if (!fs::exists(path, ec) && !fs::exists(path + ".gz", ec))
+      return path;
+  }
+}
+
+void LogArchiver::archive(std::string rotatedPath) {
+  post([this, path = std::move(rotatedPath)] {
+    if (policy_.compress)
+      compress(path);
+    prune();
+  });
+}
+
+void LogArchiver::prune() {
+  if (policy_.keep == 0)
+    return;
+
+  const fs::path active(filePath_);
+  const std::string prefix = active.filename().string() + ".";
+  fs::path dir = active.parent_path();
+  if (dir.empty())
+    dir = ".";
+
+  // Rotated names start with the time stamp, so they sort by age
+  std::vector<fs::path> rotated;
+  std::error_code ec;
+  for (const auto &entry : fs::directory_iterator(dir, ec)) {
+    const std::string name = entry.path().filename().string();
+    if (name.size() > prefix.size() &&
+        name.compare(0, prefix.size(), prefix) == 0 &&
+        std::isdigit(static_cast<unsigned char>(name[prefix.size()])))
+      rotated.push_back(entry.path());
+  }
+  if (rotated.size() <= policy_.keep)
+    return;
+
+  std::sort(rotated.begin(), rotated.end());
+  const std::size_t excess = rotated.size() - policy_.keep;
+  for (std::size_t i{}; i < excess; ++i)
+    fs::remove(rotated[i], ec);
+}
+
+} // namespace helios::logger
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include <core/active_h_object.hpp>
+
+#include "log_config.hpp"
+
+namespace helios::logger {
+
+/**
+ * @brief Decides when a FileSink rotates its file and what is kept.
+ *
+ * @details
+ * - The defaults are taken from 'log_config.hpp' which is generated by CMake.
+ * - Rotation is disabled if both 'maxSize' and 'interval' are 0.
+ */
+struct RotationPolicy {
+  /**
+   * @brief Rotates before the file grows beyond this size in bytes. 0 disables
+   *        it.
+   */
+  std::size_t maxSize{LOG_ROTATE_SIZE};
+
+  /**
+   * @brief Rotates at every multiple of this interval. 0 disables it.
+   */
+  std::chrono::seconds interval{LOG_ROTATE_INTERVAL_S};
+
+  /**
+   * @brief Number of rotated files kept. 0 keeps all of them.
+   */
+  std::size_t keep{LOG_ROTATE_KEEP};
+
+  /**
+   * @brief Compresses the rotated files with gzip.
+   */
+  bool compress{ENABLE_ROTATE_COMPRESS};
+
+  /**
+   * @brief Returns true if the file is rotated at all.
+   */
+  bool enabled() const { return maxSize > 0 || interval.count() > 0; }
+}; // struct RotationPolicy
+
+/**
+ * @class logger::LogArchiver
+ *
+ * @brief Compresses the rotated log files and removes the oldest ones in its
+ *        own thread.
+ *
+ * @details
+ * - Rotated files are named '<file>.<YYYYmmdd-HHMMSS>.<NNN>' and get a '.gz'
+ *   suffix when compressed, so their names sort by age.
+ * - After every archived file, only the newest 'keep' rotated files are left.
+ * - Compression is skipped if the module is built without zlib.
+ *
+ * @note
+ * - All public functions are asynchronous.
+ * - All public functions are thread-safe.
+ */
+class LogArchiver : public core::ActiveHObject {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param filePath Path of the active log file.
+   * @param policy Rotation policy.
+   */
+  LogArchiver(std::string filePath, RotationPolicy policy);
+
+  /**
+   * @brief Virtual destructor.
+   *
+   * @note
+   * - Blocks until all the queued files are archived.
+   */
+  ~LogArchiver() override;
+
+  /**
+   * @brief Returns a free name for the next rotated file.
+   *
+   * @param now Time of the rotation.
+   */
+  std::string rotatedPath(std::chrono::system_clock::time_point now) const;
+
+  /**
+   * @brief Compresses a rotated file and removes the oldest rotated files.
+   *
+   * @param rotatedPath Path of the rotated file.
+   */
+  void archive(std::string rotatedPath);
+
+private:
+  /**
+   * @brief Path of the active log file.
+   */
+  const std::string filePath_;
+
+  /**
+   * @brief Rotation policy.
+   */
+  const RotationPolicy policy_;
+
+  /**
+   * @brief Removes the oldest rotated files beyond the retention limit.
+   */
+  void prune();
+}; // class LogArchiver
+
+} // namespace helios::logger
@@ -0,0 +1,439 @@
+#include "log_formatter.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string_view>
+
+#include "log_config.hpp"
+
+namespace {
+
+/**
+ * @brief Reads a value of type T from the argument bytes.
+ *
+ * @param p Position of the value. Advanced past it.
+ */
+template <typename T> T read(const std::byte *&p) {
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  p += sizeof(T);
+  return value;
+}
+
+/**
+ * @brief Appends a number in its shortest text form.
+ */
+template <typename T> void appendNumber(T value, std::string &out) {
+  char buf[32];
+  auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+  out.append(buf, end);
+}
+
+/**
+ * @brief Renders one argument and advances past it.
+ */
+void renderArg(helios::logger::ArgType type, const std::byte *&p,
+               std::string &out) {
+  using helios::logger::ArgType;
+  switch (type) {
+  case ArgType::Bool:
+    out += read<char>(p) ? "true" : "false";
+    break;
+  case ArgType::Char:
+    out += read<char>(p);
+    break;
+  case ArgType::Int:
+    appendNumber(read<std::int64_t>(p), out);
+    break;
+  case ArgType::UInt:
+    appendNumber(read<std::uint64_t>(p), out);
+    break;
+  case ArgType::Double:
+    appendNumber(read<double>(p), out);
+    break;
+  case ArgType::String: {
+    auto len = read<std::uint16_t>(p);
+    out.append(reinterpret_cast<const char *>(p), len);
+    p += len;
+    break;
+  }
+  }
+}
+
+/**
+ * @brief Appends a string as a quoted JSON string.
+ */
+void appendJsonString(std::string_view s, std::string &out) {
+  out += '"';
+  for (char c : s) {
+    switch (c) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\r':
+      out += "\\r";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+        out += buf;
+      } else {
+        out += c;
+      }
+    }
+  }
+  out += '"';
+}
+
+/**
+ * @brief Appends a logfmt value. Quoted if it is empty or contains spaces,
+ *        quotes, '=' or control characters.
+ */
+void appendLogfmtValue(std::string_view s, std::string &out) {
+  const bool quote = s.empty() || std::any_of(s.begin(), s.end(), [](char c) {
+                       return c == ' ' || c == '"' || c == '=' ||
+                              static_cast<unsigned char>(c) < 0x20;
+                     });
+  if (quote)
+    appendJsonString(s, out);
+  else
+    out += s;
+}
+
+/**
+ * @brief Reads a string argument and advances past it.
+ */
+std::string_view readString(const std::byte *&p) {
+  const auto len = read<std::uint16_t>(p);
+  std::string_view s(reinterpret_cast<const char *>(p), len);
+  p += len;
+  return s;
+}
+
+/**
+ * @brief Calls a function for each key/value field of a structured message.
+ *
+ * @param fn Called with the key, the type of the value and the position of
+ *        the value. Shall advance the position past the value.
+ */
+template <typename Fn>
+void forEachField(const helios::logger::LogMessage &msg, Fn &&fn) {
+  const std::byte *p = msg.args.data();
+  const std::size_t count = std::min(msg.format.count, msg.args.count());
+  for (std::size_t i{0}; i < count; ++i) {
+    const std::string_view key = readString(p);
+    fn(key, msg.format.types[i], p);
+  }
+}
+
+/**
+ * @brief Returns true if a field key needs a '_' prefix: it is empty, starts
+ *        with '_' or is named like a member written before the fields.
+ *
+ * @details
+ * - Prefixed keys start with '_' and the others don't, so distinct keys stay
+ *   distinct and never repeat a member of the message.
+ */
+bool needsPrefix(std::string_view key) {
+  return key.empty() || key.front() == '_' || key == "time" ||
+         key == "level" || key == "tag" || key == "msg";
+}
+
+/**
+ * @brief Appends a field key as JSON.
+ */
+void appendJsonKey(std::string_view key, std::string &out) {
+  if (!needsPrefix(key)) {
+    appendJsonString(key, out);
+    return;
+  }
+  std::string prefixed{"_"};
+  prefixed += key;
+  appendJsonString(prefixed, out);
+}
+
+/**
+ * @brief Appends a field key as logfmt.
+ *
+ * @details
+ * - Keys can't be quoted, so spaces, quotes, '=' and control characters are
+ *   replaced by '_'.
+ */
+void appendLogfmtKey(std::string_view key, std::string &out) {
+  if (needsPrefix(key))
+    out += '_';
+  for (char c : key) {
+    const bool invalid = c == '"' || c == '=' ||
+                         static_cast<unsigned char>(c) <= 0x20 || c == 0x7F;
+    out += invalid ? '_' : c;
+  }
+}
+
+/**
+ * @brief Appends a field value as JSON.
+ */
+void appendJsonValue(helios::logger::ArgType type, const std::byte *&p,
+                     std::string &out) {
+  using helios::logger::ArgType;
+  switch (type) {
+  case ArgType::Char:
+    appendJsonString(std::string_view(reinterpret_cast<const char *>(p), 1),
+                     out);
+    p += sizeof(char);
+    break;
+  case ArgType::String:
+    appendJsonString(readString(p), out);
+    break;
+  case ArgType::Double: {
+    const std::byte *value = p;
+    if (!std::isfinite(read<double>(value))) {
+      out += "null"; // JSON has no NaN or infinity
+      p = value;
+      break;
+    }
+    renderArg(type, p, out);
+    break;
+  }
+  default:
+    renderArg(type, p, out);
+  }
+}
+
+/**
+ * @brief Appends a field value as logfmt.
+ */
+void appendLogfmtField(helios::logger::ArgType type, const std::byte *&p,
+                       std::string &out) {
+  using helios::logger::ArgType;
+  if (type == ArgType::String) {
+    appendLogfmtValue(readString(p), out);
+  } else {
+    std::string value;
+    renderArg(type, p, value);
+    appendLogfmtValue(value, out);
+  }
+}
+
+/**
+ * @brief Appends the message of a log message without its fields and without
+ *        a trailing new line.
+ */
+void appendMessage(const helios::logger::LogMessage &msg, std::string &out) {
+  if (msg.format.structured) {
+    out += msg.format.fmt;
+  } else if (msg.format.fmt) {
+    helios::logger::renderArgs(msg.format, msg.args, out);
+  } else {
+    std::string_view body = msg.body;
+    while (!body.empty() && body.back() == '\n')
+      body.remove_suffix(1);
+    out += body;
+  }
+}
+
+/**
+ * @brief Date and time rendered for one second.
+ */
+struct TimestampCache {
+  /**
+   * @brief Second of the rendered text.
+   */
+  std::time_t second{-1};
+
+  /**
+   * @brief Rendered date and time.
+   */
+  char text[32];
+
+  /**
+   * @brief Length of 'text'.
+   */
+  std::size_t len{0};
+}; // struct TimestampCache
+
+} // namespace
+
+namespace helios::logger {
+
+const char *levelToString(LogLevel lvl) {
+  switch (lvl) {
+  case LogLevel::Debug:
+    return "DEBUG";
+  case LogLevel::Info:
+    return "INFO";
+  case LogLevel::Warning:
+    return "WARN";
+  case LogLevel::Error:
+    return "ERROR";
+  }
+  return "UNKNOWN";
+}
+
+void renderArgs(const LogFormat &format, const LogArgs &args,
+                std::string &out) {
+  const std::byte *p = args.data();
+  std::size_t next{0};
+  for (const char *c = format.fmt; *c; ++c) {
+    if (c[0] == '{' && c[1] == '}' && next < format.count) {
+      if (next < args.count())
+        renderArg(format.types[next], p, out);
+      ++next;
+      ++c;
+      continue;
+    }
+    out += *c;
+  }
+}
+
+void appendTimestamp(std::chrono::system_clock::time_point tp,
+                     std::string &out, int decimals) {
+  using namespace std::chrono;
+  thread_local TimestampCache cache;
+
+  const auto second = floor<seconds>(tp);
+  const std::time_t t = system_clock::to_time_t(second);
+  if (t != cache.second) {
+    // localtime_r() takes a libc lock, so render at most once per second
+    std::tm tm{};
+    localtime_r(&t, &tm);
+    cache.len = std::strftime(cache.text, sizeof(cache.text),
+                              "%Y-%m-%d %H:%M:%S", &tm);
+    cache.second = t;
+  }
+  out.append(cache.text, cache.len);
+
+  decimals = std::clamp(decimals, 0, 9);
+  if (decimals > 0) {
+    auto fraction = duration_cast<nanoseconds>(tp - second).count();
+    for (int i{decimals}; i < 9; ++i)
+      fraction /= 10;
+    char digits[9];
+    for (int i{decimals - 1}; i >= 0; --i) {
+      digits[i] = static_cast<char>('0' + fraction % 10);
+      fraction /= 10;
+    }
+    out += '.';
+    out.append(digits, static_cast<std::size_t>(decimals));
+  }
+}
+
+std::string formatText(const LogMessage &msg) {
+  std::string final;
+  final.reserve(64 + msg.body.size());
+  // Format time
+  final += '[';
+  appendTimestamp(msg.timestamp, final);
+  final += ']';
+  // Format log level
+  final += " [";
+  final += levelToString(msg.level);
+  switch (msg.level) {
+  case LogLevel::Info:
+  case LogLevel::Warning:
+    final += "] ";
+    break;
+  default:
+    final += "]";
+  }
+  // Format tag
+  final += " [";
+  if (msg.tag)
+    final += *msg.tag;
+  final += "] ";
+
+  // Append actual log msg
+  if (msg.format.structured) {
+    final += msg.format.fmt;
+    forEachField(msg, [&final](auto key, ArgType type, const std::byte *&p) {
+      final += ' ';
+      appendLogfmtKey(key, final);
+      final += '=';
+      appendLogfmtField(type, p, final);
+    });
+    final += '\n';
+  } else if (msg.format.fmt) {
+    renderArgs(msg.format, msg.args, final);
+    final += '\n';
+  } else {
+    final += msg.body;
+  }
+
+  return final;
+}
+
+std::string formatJson(const LogMessage &msg) {
+  std::string final;
+  final.reserve(96 + msg.body.size());
+  final += "{\"time\":\"";
+  appendTimestamp(msg.timestamp, final);
+  final += "\",\"level\":\"";
+  final += levelToString(msg.level);
+  final += "\",\"tag\":";
+  appendJsonString(msg.tag ? *msg.tag : std::string_view(), final);
+  final += ",\"msg\":";
+  std::string text;
+  appendMessage(msg, text);
+  appendJsonString(text, final);
+  if (msg.format.structured) {
+    forEachField(msg, [&final](auto key, ArgType type, const std::byte *&p) {
+      final += ',';
+      appendJsonKey(key, final);
+      final += ':';
+      appendJsonValue(type, p, final);
+    });
+  }
+  final += "}\n";
+  return final;
+}
+
+std::string formatLogfmt(const LogMessage &msg) {
+  std::string final;
+  final.reserve(96 + msg.body.size());
+  final += "time=\"";
+  appendTimestamp(msg.timestamp, final);
+  final += "\" level=";
+  final += levelToString(msg.level);
+  final += " tag=";
+  appendLogfmtValue(msg.tag ? *msg.tag : std::string_view(), final);
+  final += " msg=";
+  std::string text;
+  appendMessage(msg, text);
+  appendLogfmtValue(text, final);
+  if (msg.format.structured) {
+    forEachField(msg, [&final](auto key, ArgType type, const std::byte *&p) {
+      final += ' ';
+      appendLogfmtKey(key, final);
+      final += '=';
+      appendLogfmtField(type, p, final);
+    });
+  }
+  final += '\n';
+  return final;
+}
+
+std::string formatMessage(const LogMessage &msg, OutputFormat format) {
+  switch (format) {
+  case OutputFormat::Json:
+    return formatJson(msg);
+  case OutputFormat::Logfmt:
+    return formatLogfmt(msg);
+  default:
+    return formatText(msg);
+  }
+}
+
+} // namespace helios::logger
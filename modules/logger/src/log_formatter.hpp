@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include "log_config.hpp"
+#include "log_message.hpp"
+#include "logger/output_format.hpp"
+
+namespace helios::logger {
+
+/**
+ * @brief Converts the log level to a relevant string.
+ */
+const char *levelToString(LogLevel lvl);
+
+/**
+ * @brief Appends a time stamp as 'YYYY-mm-dd HH:MM:SS' in local time,
+ *        followed by sub-second digits if configured.
+ *
+ * @details
+ * - The date and time are rendered once per second for each thread and cached.
+ *   Only the sub-second digits are rendered for every call.
+ *
+ * @param tp Time stamp.
+ * @param out String to append to.
+ * @param decimals Number of sub-second digits, at most 9. Defaults to
+ *        LOG_TIME_DECIMALS.
+ */
+void appendTimestamp(std::chrono::system_clock::time_point tp,
+                     std::string &out, int decimals = LOG_TIME_DECIMALS);
+
+/**
+ * @brief Appends the rendered arguments of a deferred message.
+ *
+ * @param format Format of the message.
+ * @param args Arguments of the message.
+ * @param out String to append to.
+ */
+void renderArgs(const LogFormat &format, const LogArgs &args, std::string &out);
+
+/**
+ * @brief Formats a log message as '[time] [LEVEL] [tag] body'.
+ *
+ * @details
+ * - The fields of a structured message follow the message as 'key=value',
+ *   with their keys written like in formatLogfmt().
+ *
+ * @param msg Log message.
+ *
+ * @return The formatted string.
+ */
+std::string formatText(const LogMessage &msg);
+
+/**
+ * @brief Formats a log message as one line of JSON.
+ *
+ * @details
+ * - The object has the members "time", "level", "tag" and "msg", followed by
+ *   the fields of a structured message.
+ * - A field key that is empty, starts with '_' or is named like one of these
+ *   members gets a '_' prefix, so no member is repeated.
+ *
+ * @param msg Log message.
+ *
+ * @return The formatted string.
+ */
+std::string formatJson(const LogMessage &msg);
+
+/**
+ * @brief Formats a log message as one line of logfmt.
+ *
+ * @details
+ * - The line has the keys 'time', 'level', 'tag' and 'msg', followed by the
+ *   fields of a structured message.
+ * - Field keys are prefixed like in formatJson(). Keys can't be quoted, so
+ *   their quotes, '=', spaces and control characters are replaced by '_'.
+ *
+ * @param msg Log message.
+ *
+ * @return The formatted string.
+ */
+std::string formatLogfmt(const LogMessage &msg);
+
+/**
+ * @brief Formats a log message in the given output format.
+ *
+ * @param msg Log message.
+ * @param format Output format.
+ *
+ * @return The formatted string.
+ */
+std::string formatMessage(const LogMessage &msg, OutputFormat format);
+
+} // namespace helios::logger
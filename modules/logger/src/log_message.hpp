@@ -1,22 +1,106 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <string>
+#include <utility>
+
+#include "logger/log_args.hpp"
+#include "logger/log_level.hpp"
 
 namespace helios::logger {
 
+class OverloadGuard;
+
+/**
+ * @class logger::Admission
+ *
+ * @brief Admission of a message into an OverloadGuard, released when the
+ *        message is destroyed.
+ *
+ * @details
+ * - The sinks share the published message, so it is destroyed, and released,
+ *   at the end of the last sink handler.
+ * - Moves with the message. A copy holds no admission, so every admission is
+ *   released once.
+ */
+class Admission {
+public:
+  Admission() = default;
+  explicit Admission(OverloadGuard *guard) : guard_{guard} {}
+  ~Admission() { reset(); }
+  Admission(const Admission &) {}
+  Admission &operator=(const Admission &other) {
+    if (this != &other)
+      reset();
+    return *this;
+  }
+  Admission(Admission &&other) noexcept
+      : guard_{std::exchange(other.guard_, nullptr)} {}
+  Admission &operator=(Admission &&other) noexcept {
+    if (this != &other) {
+      reset();
+      guard_ = std::exchange(other.guard_, nullptr);
+    }
+    return *this;
+  }
+
+private:
+  /**
+   * @brief Guard that admitted the message. nullptr if none.
+   */
+  OverloadGuard *guard_{nullptr};
+
+  /**
+   * @brief Releases the admission, if any.
+   */
+  void reset() noexcept;
+}; // class Admission
+
 /**
  * @brief Represents a log message.
+ *
+ * @details
+ * - A streamed message carries its text in 'body'.
+ * - A deferred message carries its format and raw arguments instead. They are
+ *   rendered by the sinks.
  */
 struct LogMessage {
   /**
-   * @brief The message.
+   * @brief Log level.
+   */
+  LogLevel level{LogLevel::Debug};
+
+  /**
+   * @brief Time stamp when the message was created.
+   */
+  std::chrono::system_clock::time_point timestamp;
+
+  /**
+   * @brief Name of the logger that created the message.
+   */
+  std::shared_ptr<const std::string> tag;
+
+  /**
+   * @brief Text of a streamed message.
+   */
+  std::string body;
+
+  /**
+   * @brief Format of a deferred message. Its 'fmt' is nullptr for streamed
+   *        messages.
+   */
+  LogFormat format{nullptr, nullptr, 0};
+
+  /**
+   * @brief Arguments of a deferred message.
    */
-  std::string msg;
+  LogArgs args;
 
   /**
-   * @brief Constructor.
+   * @brief Admission into the OverloadGuard when LOG_QUEUE_CAPACITY is set.
    */
-  template <typename S> LogMessage(S &&s) : msg(std::forward<S>(s)) {}
+  Admission admission;
 }; // struct LogMessage
 
 } // namespace helios::logger
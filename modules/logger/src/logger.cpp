@@ -1,11 +1,17 @@
 #include "logger/logger.hpp"
 
+#include <algorithm>
 #include <core/h_loop.hpp>
 #include <vector>
 
+#include "binary_sink.hpp"
 #include "file_sink.hpp"
+#include "level_registry.hpp"
 #include "log_config.hpp"
 #include "log_message.hpp"
+#include "mapped_sink.hpp"
+#include "overload_guard.hpp"
+#include "ring_backend.hpp"
 #include "standard_output_sink.hpp"
 
 namespace helios::logger {
@@ -22,11 +28,30 @@ public:
    */
   LogMessageFactory make(LogLevel lvl);
 
+  /**
+   * @brief Hands a deferred message to the backend.
+   *
+   * @param lvl Log level.
+   * @param format Format of the call site.
+   * @param args Raw arguments.
+   */
+  void makeDeferred(LogLevel lvl, const LogFormat &format, const LogArgs &args);
+
 private:
   /**
-   * @brief Name of the logger.
+   * @brief Name of the logger. Shared with the messages.
+   */
+  const std::shared_ptr<const std::string> name_;
+
+  /**
+   * @brief Id of the name in the mapped sink. Looked up on first use.
+   */
+  std::uint64_t mappedTag_{0};
+
+  /**
+   * @brief Indicates if 'mappedTag_' is looked up or not yet.
    */
-  const std::string name_;
+  std::once_flag isMappedTagSet_;
 
   /**
    * @brief Runs the sinks.
@@ -43,6 +68,23 @@ private:
    */
   static std::vector<std::shared_ptr<core::HObject>> sinks_;
 
+  /**
+   * @brief Queues the messages of the producing threads when the Ring backend
+   *        is enabled.
+   */
+  static std::unique_ptr<RingBackend> ringBackend_;
+
+  /**
+   * @brief Writes the messages from the producing threads when the mapped
+   *        sink is enabled.
+   */
+  static std::unique_ptr<MappedSink> mappedSink_;
+
+  /**
+   * @brief Bounds the messages in flight when LOG_QUEUE_CAPACITY is set.
+   */
+  static std::unique_ptr<OverloadGuard> overloadGuard_;
+
   /**
    * @brief Indicates if the log sinks are created or not yet.
    */
@@ -52,36 +94,147 @@ private:
    * @brief Checks the configured log sinks and creates them.
    */
   static void initSinks();
+
+  /**
+   * @brief Hands a message to the configured backend.
+   *
+   * @param msg Log message.
+   */
+  void dispatch(LogMessage msg);
+
+  /**
+   * @brief Publishes a message to the sinks.
+   *
+   * @param msg Log message.
+   */
+  static void publish(LogMessage msg);
+
+  /**
+   * @brief Publishes the pending drop report after
+   *        LOG_DROP_REPORT_INTERVAL_MS on the loop.
+   *
+   * @details
+   * - Started by the first drop and repeated until a report finds nothing,
+   *   so an idle logger is not woken.
+   */
+  static void scheduleReport();
 }; // class Impl
 
 Logger::Logger(std::string name)
-    : impl_{std::make_unique<Logger::Impl>(std::move(name))} {}
+    : threshold_{LevelRegistry::instance().threshold(name)} {
+  impl_ = std::make_unique<Logger::Impl>(std::move(name));
+}
 
 Logger::~Logger() = default;
 
+void Logger::setLevel(LogLevel lvl) {
+  LevelRegistry::instance().setGlobal(lvl);
+}
+
+void Logger::setLevel(const std::string &name, LogLevel lvl) {
+  LevelRegistry::instance().set(name, lvl);
+}
+
+void Logger::resetLevel(const std::string &name) {
+  LevelRegistry::instance().clear(name);
+}
+
 LogMessageFactory Logger::debug() { return impl_->make(LogLevel::Debug); }
 LogMessageFactory Logger::info() { return impl_->make(LogLevel::Info); }
 LogMessageFactory Logger::warn() { return impl_->make(LogLevel::Warning); }
 LogMessageFactory Logger::error() { return impl_->make(LogLevel::Error); }
 
-Logger::Impl::Impl(std::string name) : name_{name} {}
+void Logger::logDeferred(LogLevel lvl, const LogFormat &format,
+                         const LogArgs &args) {
+  impl_->makeDeferred(lvl, format, args);
+}
+
+Logger::Impl::Impl(std::string name)
+    : name_{std::make_shared<const std::string>(std::move(name))} {}
 
 std::shared_ptr<core::HBus> Logger::Impl::logBus_{
     std::make_shared<core::HBus>()
 };
 
+// Defined before the loop so that it outlives the messages pending on the loop
+std::unique_ptr<OverloadGuard> Logger::Impl::overloadGuard_;
+
 std::shared_ptr<core::HLoop> Logger::Impl::loop_{
     std::make_shared<core::HLoop>()
 };
 
 std::vector<std::shared_ptr<core::HObject>> Logger::Impl::sinks_;
 
+std::unique_ptr<RingBackend> Logger::Impl::ringBackend_;
+
+std::unique_ptr<MappedSink> Logger::Impl::mappedSink_;
+
 std::once_flag Logger::Impl::isSinksInitialized_;
 
 LogMessageFactory Logger::Impl::make(LogLevel lvl) {
   std::call_once(isSinksInitialized_, [] { Logger::Impl::initSinks(); });
-  return LogMessageFactory(lvl, name_, [this](std::string msg) {
-    logBus_->publish<LogMessage>(std::move(msg));
+  return LogMessageFactory([this, lvl](auto timestamp, std::string body) {
+    LogMessage msg;
+    msg.level = lvl;
+    msg.timestamp = timestamp;
+    msg.tag = name_;
+    msg.body = std::move(body);
+    dispatch(std::move(msg));
+  });
+}
+
+void Logger::Impl::makeDeferred(LogLevel lvl, const LogFormat &format,
+                                const LogArgs &args) {
+  std::call_once(isSinksInitialized_, [] { Logger::Impl::initSinks(); });
+  LogMessage msg;
+  msg.level = lvl;
+  msg.timestamp = std::chrono::system_clock::now();
+  msg.tag = name_;
+  msg.format = format;
+  msg.args = args;
+  dispatch(std::move(msg));
+}
+
+void Logger::Impl::dispatch(LogMessage msg) {
+  // Written before queueing so that a crash can't lose it
+  if constexpr (ENABLE_MAPPED_SINK) {
+    std::call_once(isMappedTagSet_,
+                   [this] { mappedTag_ = mappedSink_->tagId(*name_); });
+    mappedSink_->write(msg, mappedTag_);
+  }
+  if constexpr (LOG_QUEUE_CAPACITY > 0) {
+    // The loop releases the messages, so it can't wait for a free slot
+    const bool mayBlock = LOG_OVERLOAD_POLICY != OverloadPolicy::Block ||
+                          !loop_->runsInCurrentThread();
+    if (!overloadGuard_->admit(msg.level, mayBlock)) {
+      if (overloadGuard_->armReport())
+        scheduleReport(); // First drop since the last report
+      return;
+    }
+    msg.admission = Admission(overloadGuard_.get());
+  }
+  if constexpr (ENABLE_RING_BACKEND)
+    ringBackend_->push(std::move(msg));
+  else
+    publish(std::move(msg));
+}
+
+void Logger::Impl::publish(LogMessage msg) {
+  logBus_->publish<LogMessage>(std::move(msg));
+}
+
+void Logger::Impl::scheduleReport() {
+  const std::chrono::milliseconds interval{
+      std::max(LOG_DROP_REPORT_INTERVAL_MS, 1L)
+  };
+  loop_->postAfter(interval, [] {
+    if (auto report =
+            overloadGuard_->takeReport(std::chrono::steady_clock::now())) {
+      publish(std::move(*report));
+      scheduleReport(); // Check again for the drops that follow
+    } else if (overloadGuard_->disarmReport()) {
+      scheduleReport();
+    }
   });
 }
 
@@ -91,7 +244,34 @@ void Logger::Impl::initSinks() {
   }
 
   if constexpr (ENABLE_FILE_SINK) {
-    sinks_.emplace_back(std::make_shared<FileSink>(loop_, logBus_));
+    sinks_.emplace_back(
+        std::make_shared<FileSink>(loop_, logBus_, LOG_FILE_PATH)
+    );
+  }
+
+  if constexpr (ENABLE_BINARY_SINK) {
+    sinks_.emplace_back(
+        std::make_shared<BinarySink>(loop_, logBus_, LOG_BINARY_FILE_PATH)
+    );
+  }
+
+  if constexpr (ENABLE_MAPPED_SINK) {
+    mappedSink_ = std::make_unique<MappedSink>(
+        LOG_MAPPED_FILE_PATH, LOG_MAPPED_SIZE, LOG_MAPPED_SLOT_SIZE
+    );
+  }
+
+  if constexpr (LOG_QUEUE_CAPACITY > 0) {
+    overloadGuard_ = std::make_unique<OverloadGuard>(
+        LOG_QUEUE_CAPACITY, LOG_OVERLOAD_POLICY,
+        std::chrono::milliseconds(LOG_DROP_REPORT_INTERVAL_MS)
+    );
+  }
+
+  if constexpr (ENABLE_RING_BACKEND) {
+    ringBackend_ = std::make_unique<RingBackend>(
+        LOG_RING_CAPACITY, [](LogMessage msg) { publish(std::move(msg)); }
+    );
   }
 }
 
@@ -0,0 +1,346 @@
+#include "mapped_sink.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "buffered_writer.hpp"
+
+namespace {
+
+using helios::logger::MappedSink;
+
+/**
+ * @brief Magic bytes at the start of a mapped file.
+ */
+constexpr char MAGIC[4] = {'H', 'M', 'A', 'P'};
+
+/**
+ * @brief Version of the layout.
+ */
+constexpr std::uint32_t VERSION = 3;
+
+/**
+ * @brief Header at the start of the file.
+ */
+struct FileHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t slotSize;
+  std::uint32_t slotCount;
+  std::uint64_t head; // Last reserved sequence number
+  std::uint32_t tagCount;
+  char reserved[36];
+}; // struct FileHeader
+
+static_assert(sizeof(FileHeader) == 64);
+
+/**
+ * @brief Entry of the table of tags, which follows the file header. The id
+ *        of a tag is its index plus one.
+ */
+struct TagEntry {
+  std::uint8_t len;
+  char name[63];
+}; // struct TagEntry
+
+static_assert(sizeof(TagEntry) == 64);
+
+/**
+ * @brief Number of entries of the table of tags.
+ */
+constexpr std::size_t TAG_COUNT = 256;
+
+static_assert(MappedSink::PREFIX_SIZE ==
+              sizeof(FileHeader) + TAG_COUNT * sizeof(TagEntry));
+
+/**
+ * @brief Header at the start of each slot, followed by the records.
+ */
+struct SlotHeader {
+  std::uint64_t seq; // 0 while empty, BUSY is set while being written
+  std::uint32_t len;
+  std::uint32_t reserved;
+}; // struct SlotHeader
+
+static_assert(sizeof(SlotHeader) == 16);
+
+/**
+ * @brief Marks the sequence number of a slot being written.
+ */
+constexpr std::uint64_t BUSY = std::uint64_t{1} << 63;
+
+/**
+ * @brief Views a 64-bit field of the mapping as an atomic.
+ */
+std::atomic<std::uint64_t> &atomicAt(std::uint64_t &field) {
+  static_assert(sizeof(std::atomic<std::uint64_t>) == sizeof(std::uint64_t));
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+  return *reinterpret_cast<std::atomic<std::uint64_t> *>(&field);
+}
+
+/**
+ * @brief Returns true if a header describes the given layout.
+ */
+bool matches(const FileHeader &header, std::size_t slotSize,
+             std::size_t slotCount) {
+  return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+         header.version == VERSION && header.slotSize == slotSize &&
+         header.slotCount == slotCount && header.tagCount <= TAG_COUNT;
+}
+
+} // namespace
+
+namespace helios::logger {
+
+MappedSink::MappedSink(const std::string &filePath, std::size_t size,
+                       std::size_t slotSize) {
+  // Slots are cache-line aligned and hold at least the slot header
+  slotSize_ = std::max<std::size_t>((slotSize + 63) / 64 * 64, 64);
+  slotCount_ = size > PREFIX_SIZE ? (size - PREFIX_SIZE) / slotSize_ : 0;
+  if (slotCount_ == 0)
+    return;
+  size_ = PREFIX_SIZE + slotCount_ * slotSize_;
+
+  const auto dir = std::filesystem::path(filePath).parent_path();
+  if (!dir.empty()) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+  }
+  int fd = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0)
+    return;
+
+  // Continue an existing file with the same layout, otherwise start over
+  FileHeader header{};
+  struct stat st {};
+  const bool reuse =
+      ::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) == size_ &&
+      ::pread(fd, &header, sizeof(header), 0) ==
+          static_cast<ssize_t>(sizeof(header)) &&
+      matches(header, slotSize_, slotCount_);
+  if (!reuse && st.st_size > 0) {
+    // Another size or version. Its records may be all that is left of a
+    // crash, so keep them for helios-logdecode rather than zero them.
+    ::close(fd);
+    if (!moveAside(filePath))
+      return;
+    fd = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC,
+                0644);
+    if (fd < 0)
+      return;
+  }
+  if (!reuse) {
+    // Allocate the blocks now so writing never hits a full disk as SIGBUS
+    if (::posix_fallocate(fd, 0, static_cast<off_t>(size_)) != 0) {
+      ::close(fd);
+      return;
+    }
+  }
+
+  void *p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd); // The mapping keeps the file
+  if (p == MAP_FAILED)
+    return;
+  base_ = static_cast<std::byte *>(p);
+
+  auto *h = reinterpret_cast<FileHeader *>(base_);
+  if (!reuse) {
+    std::memcpy(h->magic, MAGIC, sizeof(MAGIC));
+    h->version = VERSION;
+    h->slotSize = static_cast<std::uint32_t>(slotSize_);
+    h->slotCount = static_cast<std::uint32_t>(slotCount_);
+    return;
+  }
+
+  // Keep the ids of the previous run, its records refer to them
+  const auto *table = reinterpret_cast<const TagEntry *>(base_ + sizeof(*h));
+  for (std::uint32_t i{}; i < h->tagCount; ++i)
+    tags_.try_emplace(std::string(table[i].name, table[i].len), i + 1);
+  // Slots left busy by a crash would block their next writer
+  for (std::size_t i{}; i < slotCount_; ++i) {
+    auto *slotHeader = reinterpret_cast<SlotHeader *>(
+        base_ + PREFIX_SIZE + i * slotSize_
+    );
+    if (slotHeader->seq & BUSY)
+      slotHeader->seq = 0;
+  }
+}
+
+MappedSink::~MappedSink() {
+  if (base_)
+    ::munmap(base_, size_);
+}
+
+std::uint64_t MappedSink::tagId(const std::string &tag) {
+  if (!base_)
+    return 0;
+  std::lock_guard lock(tagsMtx_);
+  if (auto it = tags_.find(tag); it != tags_.end())
+    return it->second;
+  auto *header = reinterpret_cast<FileHeader *>(base_);
+  if (header->tagCount == TAG_COUNT)
+    return 0;
+
+  // The entry is complete before any slot refers to it
+  auto &entry =
+      reinterpret_cast<TagEntry *>(base_ + sizeof(*header))[header->tagCount];
+  const std::size_t len = std::min(tag.size(), sizeof(entry.name));
+  std::memcpy(entry.name, tag.data(), len);
+  entry.len = static_cast<std::uint8_t>(len);
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  const std::uint64_t id = ++header->tagCount;
+  tags_.emplace(tag, id);
+  return id;
+}
+
+void MappedSink::write(const LogMessage &msg, std::uint64_t tag) {
+  if (!base_)
+    return;
+  // Reused by the thread, so encoding does not allocate once warmed up
+  thread_local std::string payload;
+  thread_local std::string records;
+  records.clear();
+  encodeStandalone(msg, tag, payload, records);
+
+  const std::size_t capacity = slotSize_ - sizeof(SlotHeader);
+  if (records.size() > capacity) {
+    LogMessage cut;
+    cut.level = msg.level;
+    cut.timestamp = msg.timestamp;
+    records.clear();
+    encodeStandalone(cut, tag, payload, records);
+    // The varints of the lengths grow with the body
+    const std::size_t overhead = records.size() + 8;
+    if (overhead >= capacity)
+      return;
+    cut.body = std::string_view(msg.format.fmt ? msg.format.fmt : msg.body)
+                   .substr(0, capacity - overhead);
+    records.clear();
+    encodeStandalone(cut, tag, payload, records);
+  }
+
+  auto *header = reinterpret_cast<FileHeader *>(base_);
+  const std::uint64_t seq =
+      atomicAt(header->head).fetch_add(1, std::memory_order_relaxed) + 1;
+  std::byte *slot = slotAt(seq);
+  auto *slotHeader = reinterpret_cast<SlotHeader *>(slot);
+  std::atomic<std::uint64_t> &slotSeq = atomicAt(slotHeader->seq);
+
+  // Claim the slot from the writer of the previous lap
+  std::uint64_t current = slotSeq.load(std::memory_order_relaxed);
+  while (true) {
+    if ((current & ~BUSY) > seq)
+      return; // A writer of a later lap took it, this record is overwritten
+    if (current & BUSY) {
+      std::this_thread::yield();
+      current = slotSeq.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (slotSeq.compare_exchange_weak(current, seq | BUSY,
+                                      std::memory_order_acquire,
+                                      std::memory_order_relaxed))
+      break;
+  }
+
+  // A crash of the process only keeps the stores made so far, so only their
+  // order matters: claim the slot, fill it, then publish it
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  slotHeader->len = static_cast<std::uint32_t>(records.size());
+  std::memcpy(slot + sizeof(SlotHeader), records.data(), records.size());
+  slotSeq.store(seq, std::memory_order_release);
+}
+
+std::byte *MappedSink::slotAt(std::uint64_t seq) const {
+  return base_ + PREFIX_SIZE + ((seq - 1) % slotCount_) * slotSize_;
+}
+
+bool isMappedLog(const std::string &filePath) {
+  std::ifstream in(filePath, std::ios::binary);
+  char magic[sizeof(MAGIC)];
+  return in.read(magic, sizeof(magic)) &&
+         std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void readMappedLog(
+    const std::string &filePath, const RecordFilter &filter,
+    const std::function<void(std::uint64_t, const LogMessage &)> &visit
+) {
+  const int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+  FileHeader header{};
+  TagEntry table[TAG_COUNT];
+  const bool valid =
+      fd >= 0 &&
+      ::pread(fd, &header, sizeof(header), 0) ==
+          static_cast<ssize_t>(sizeof(header)) &&
+      matches(header, header.slotSize, header.slotCount) &&
+      header.slotSize >= sizeof(SlotHeader) &&
+      ::pread(fd, table, sizeof(table), sizeof(header)) ==
+          static_cast<ssize_t>(sizeof(table));
+  if (!valid) {
+    if (fd >= 0)
+      ::close(fd);
+    throw std::runtime_error("Not a mapped log file");
+  }
+
+  // Every slot is decoded after the file header and the tags
+  std::string prefix;
+  std::string payload;
+  BinaryEncoder::writeHeader(prefix);
+  encodeTag(0, "", payload, prefix);
+  for (std::uint32_t i{}; i < header.tagCount; ++i)
+    encodeTag(i + 1, std::string(table[i].name, table[i].len), payload,
+              prefix);
+
+  std::vector<std::pair<std::uint64_t, std::string>> slots;
+  std::string slot(header.slotSize, '\0');
+  for (std::uint32_t i{}; i < header.slotCount; ++i) {
+    const off_t offset =
+        static_cast<off_t>(MappedSink::PREFIX_SIZE) +
+        static_cast<off_t>(i) * header.slotSize;
+    if (::pread(fd, slot.data(), slot.size(), offset) !=
+        static_cast<ssize_t>(slot.size()))
+      break; // Truncated file, keep what was read
+    SlotHeader slotHeader;
+    std::memcpy(&slotHeader, slot.data(), sizeof(slotHeader));
+    if (slotHeader.seq == 0 || (slotHeader.seq & BUSY) ||
+        slotHeader.len > header.slotSize - sizeof(SlotHeader))
+      continue;
+    // A writer may have claimed the slot while it was read
+    std::uint64_t seq{0};
+    if (::pread(fd, &seq, sizeof(seq), offset) !=
+            static_cast<ssize_t>(sizeof(seq)) ||
+        seq != slotHeader.seq)
+      continue;
+    slots.emplace_back(seq, slot.substr(sizeof(SlotHeader), slotHeader.len));
+  }
+  ::close(fd);
+
+  std::sort(slots.begin(), slots.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  for (const auto &[seq, records] : slots) {
+    std::istringstream in(prefix + records);
+    try {
+      BinaryDecoder decoder(in, filter);
+      LogMessage msg;
+      while (decoder.next(msg))
+        visit(seq, msg);
+    } catch (const std::runtime_error &) {
+      // Corrupted slot, e.g. a crash of the system, skip it
+    }
+  }
+}
+
+} // namespace helios::logger
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "binary_format.hpp"
+#include "log_message.hpp"
+
+namespace helios::logger {
+
+/**
+ * @class logger::MappedSink
+ *
+ * @brief Writes messages into a preallocated memory-mapped file from the
+ *        producing threads, so they survive a crash of the process.
+ *
+ * @details
+ * - Unlike the other sinks, it is called directly by the producing thread
+ *   before the message is queued, so no message is lost on the sink loop.
+ * - The file is a header, a table of tags and fixed-size slots used as a
+ *   ring. A slot holds a sequence number and the records of one message in
+ *   the binary log format, so the message is not rendered on the producing
+ *   thread. helios-logdecode renders them.
+ * - A tag is added to the table once per logger. Tags beyond the table are
+ *   stored as an empty tag.
+ * - A message that does not fit into a slot is stored as a streamed message
+ *   with its body, or the format of a deferred message, truncated.
+ * - A sequence number is reserved by an atomic increment. The slot is then
+ *   claimed by marking its sequence number as busy, filled and published by
+ *   storing the plain sequence number. Writers that wrap onto the same slot
+ *   take turns, and readers skip slots that are busy, e.g. after a crash
+ *   while writing.
+ * - Writing needs no system call. The mapping is shared, so written slots
+ *   live in the page cache and reach the file even if the process crashes.
+ *   They are not protected against a crash of the system.
+ * - An existing file with the same layout is continued, so the records of a
+ *   crashed run stay until they are overwritten. Another file at the path,
+ *   e.g. of another size or version, is moved aside with moveAside(). If it
+ *   can't be moved, the sink stays closed rather than erase it.
+ *
+ * @note
+ * - write() is thread-safe.
+ */
+class MappedSink {
+public:
+  /**
+   * @brief Bytes before the first slot: the file header and the table of
+   *        tags.
+   */
+  static constexpr std::size_t PREFIX_SIZE = 64 + 256 * 64;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param filePath Path of the mapped file.
+   * @param size Size of the file in bytes.
+   * @param slotSize Size of each slot in bytes.
+   */
+  MappedSink(const std::string &filePath, std::size_t size,
+             std::size_t slotSize);
+
+  /**
+   * @brief Destructor.
+   */
+  ~MappedSink();
+
+  /**
+   * @brief Delete copy and move semantics.
+   */
+  MappedSink(const MappedSink &) = delete;
+  MappedSink &operator=(const MappedSink &) = delete;
+  MappedSink(MappedSink &&) = delete;
+  MappedSink &operator=(MappedSink &&) = delete;
+
+  /**
+   * @brief Returns the id of a tag, adding it to the table if it is new.
+   *
+   * @details
+   * - Takes a lock, so callers look the id up once and keep it.
+   *
+   * @param tag Name of the tag.
+   *
+   * @return 0, the empty tag, if the table is full or the file is not mapped.
+   */
+  std::uint64_t tagId(const std::string &tag);
+
+  /**
+   * @brief Writes a message into the next slot.
+   *
+   * @param msg Log message.
+   * @param tag Id of the tag of the message, returned by tagId().
+   */
+  void write(const LogMessage &msg, std::uint64_t tag);
+
+  /**
+   * @brief Returns true if the file is mapped.
+   */
+  bool isOpen() const { return base_ != nullptr; }
+
+private:
+  /**
+   * @brief Start of the mapping. nullptr if the file could not be mapped.
+   */
+  std::byte *base_{nullptr};
+
+  /**
+   * @brief Size of the mapping.
+   */
+  std::size_t size_{0};
+
+  /**
+   * @brief Size of each slot.
+   */
+  std::size_t slotSize_{0};
+
+  /**
+   * @brief Number of slots.
+   */
+  std::size_t slotCount_{0};
+
+  /**
+   * @brief Ids of the tags in the table.
+   */
+  std::unordered_map<std::string, std::uint64_t> tags_;
+
+  /**
+   * @brief Guards tags_ and the table.
+   */
+  std::mutex tagsMtx_;
+
+  /**
+   * @brief Returns the start of a slot.
+   */
+  std::byte *slotAt(std::uint64_t seq) const;
+}; // class MappedSink
+
+/**
+ * @brief Returns true if a file starts like a mapped log file.
+ *
+ * @param filePath Path of the file.
+ */
+bool isMappedLog(const std::string &filePath);
+
+/**
+ * @brief Decodes the complete messages of a mapped file, oldest first.
+ *
+ * @details
+ * - Slots being written, left busy by a crash or changed while being read
+ *   are skipped.
+ *
+ * @param filePath Path of the file.
+ * @param filter Selects the messages.
+ * @param visit Called with the sequence number and each accepted message.
+ *        The message is only valid during the call.
+ *
+ * @throws std::runtime_error if the file is not a mapped log file.
+ */
+void readMappedLog(
+    const std::string &filePath, const RecordFilter &filter,
+    const std::function<void(std::uint64_t, const LogMessage &)> &visit
+);
+
+} // namespace helios::logger
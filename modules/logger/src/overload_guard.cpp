@@ -0,0 +1,112 @@
+#include "overload_guard.hpp"
+
+#include <algorithm>
+
+namespace helios::logger {
+
+OverloadGuard::OverloadGuard(std::size_t capacity, OverloadPolicy policy,
+                             std::chrono::milliseconds reportInterval)
+    : policy_{policy}, reportInterval_{reportInterval} {
+  capacity = std::max<std::size_t>(capacity, 1);
+  if (policy_ == OverloadPolicy::DropByLevel) {
+    // Lower levels hit their limit first and leave room for the higher ones
+    constexpr std::size_t SHARES[4] = {50, 75, 90, 100};
+    for (std::size_t i{}; i < limits_.size(); ++i)
+      limits_[i] = std::max<std::size_t>(capacity * SHARES[i] / 100, 1);
+  } else {
+    limits_.fill(capacity);
+  }
+}
+
+void Admission::reset() noexcept {
+  if (guard_)
+    std::exchange(guard_, nullptr)->release();
+}
+
+bool OverloadGuard::admit(LogLevel lvl, bool mayBlock) {
+  const auto i = static_cast<std::size_t>(lvl);
+  if (tryAcquire(limits_[i]))
+    return true;
+  if (policy_ != OverloadPolicy::Block || !mayBlock) {
+    dropped_[i].fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  waiting_.fetch_add(1, std::memory_order_seq_cst);
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this, i] { return tryAcquire(limits_[i]); });
+  }
+  waiting_.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+void OverloadGuard::release() {
+  inFlight_.fetch_sub(1, std::memory_order_seq_cst);
+  // Only lock if a producer may be waiting
+  if (waiting_.load(std::memory_order_seq_cst) > 0) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    cv_.notify_one();
+  }
+}
+
+bool OverloadGuard::armReport() {
+  // Releases the drop counted before it to disarmReport()
+  return !reportArmed_.exchange(true, std::memory_order_acq_rel);
+}
+
+bool OverloadGuard::disarmReport() {
+  reportArmed_.exchange(false, std::memory_order_acq_rel);
+  // A drop that found the report still armed didn't start the timer
+  for (const auto &dropped : dropped_) {
+    if (dropped.load(std::memory_order_relaxed) > 0)
+      return armReport();
+  }
+  return false;
+}
+
+std::optional<LogMessage>
+OverloadGuard::takeReport(std::chrono::steady_clock::time_point now) {
+  std::lock_guard<std::mutex> lock(reportMtx_);
+  if (lastReport_ != std::chrono::steady_clock::time_point{} &&
+      now - lastReport_ < reportInterval_)
+    return std::nullopt;
+
+  std::array<std::uint64_t, 4> counts;
+  std::uint64_t total{0};
+  for (std::size_t i{}; i < counts.size(); ++i) {
+    counts[i] = dropped_[i].exchange(0, std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0)
+    return std::nullopt;
+  lastReport_ = now;
+
+  using Count = std::uint64_t;
+  static const auto tag = std::make_shared<const std::string>(TAG);
+  LogMessage msg;
+  msg.level = LogLevel::Warning;
+  msg.timestamp = std::chrono::system_clock::now();
+  msg.tag = tag;
+  msg.format = {"Dropped log messages",
+                ARG_TYPES<Count, Count, Count, Count, Count>, 5, true};
+  msg.args.appendField("dropped", total);
+  msg.args.appendField("debug", counts[0]);
+  msg.args.appendField("info", counts[1]);
+  msg.args.appendField("warning", counts[2]);
+  msg.args.appendField("error", counts[3]);
+  return msg;
+}
+
+bool OverloadGuard::tryAcquire(std::size_t limit) {
+  std::size_t n = inFlight_.load(std::memory_order_relaxed);
+  do {
+    if (n >= limit)
+      return false;
+  } while (!inFlight_.compare_exchange_weak(n, n + 1,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed));
+  return true;
+}
+
+} // namespace helios::logger
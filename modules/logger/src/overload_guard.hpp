@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+#include "log_message.hpp"
+#include "logger/overload_policy.hpp"
+
+namespace helios::logger {
+
+/**
+ * @class logger::OverloadGuard
+ *
+ * @brief Bounds the number of log messages in flight between the producing
+ *        threads and the sinks.
+ *
+ * @details
+ * - A message is admitted before it is queued and released after the sinks
+ *   handled it, by the Admission it carries. At most 'capacity' messages are
+ *   in flight.
+ * - When the queue is full, the policy decides if the producer waits or the
+ *   message is dropped. The thread that releases the messages can't wait for
+ *   itself, so its messages are dropped with every policy.
+ * - With DropByLevel, a level may only fill its share of the queue: Debug
+ *   50%, Info 75%, Warning 90% and Error 100%.
+ * - Dropped messages are counted per level. The counters are turned into a
+ *   synthetic Warning message at most once per report interval.
+ * - The report is only due while messages are dropped. armReport() tells
+ *   the first drop to start the report timer, and disarmReport() stops it
+ *   once a report finds nothing.
+ *
+ * @note
+ * - All public functions are thread-safe.
+ */
+class OverloadGuard {
+public:
+  /**
+   * @brief Name of the synthetic messages.
+   */
+  static constexpr const char *TAG = "logger";
+
+  /**
+   * @brief Constructor.
+   *
+   * @param capacity Max number of messages in flight.
+   * @param policy Overload policy.
+   * @param reportInterval Min time between two drop reports.
+   */
+  OverloadGuard(std::size_t capacity, OverloadPolicy policy,
+                std::chrono::milliseconds reportInterval);
+
+  /**
+   * @brief Admits a message into the queue.
+   *
+   * @param lvl Level of the message.
+   * @param mayBlock False on the thread that releases the messages.
+   *
+   * @return False if the message shall be dropped.
+   *
+   * @note
+   * - Blocks while the queue is full with the Block policy, unless
+   *   'mayBlock' is false.
+   */
+  bool admit(LogLevel lvl, bool mayBlock = true);
+
+  /**
+   * @brief Releases an admitted message after the sinks handled it.
+   */
+  void release();
+
+  /**
+   * @brief Returns a message reporting the drops since the last report.
+   *
+   * @param now Current time.
+   *
+   * @return Nothing if nothing was dropped or the last report is too recent.
+   */
+  std::optional<LogMessage> takeReport(std::chrono::steady_clock::time_point now
+  );
+
+  /**
+   * @brief Arms the drop report after a message was dropped.
+   *
+   * @return True if it was not armed, so the caller starts the report timer.
+   */
+  bool armReport();
+
+  /**
+   * @brief Disarms the drop report once a report found nothing.
+   *
+   * @return True if a message was dropped meanwhile and the report stays
+   *         armed, so the caller keeps the report timer.
+   */
+  bool disarmReport();
+
+  /**
+   * @brief Returns the number of messages in flight.
+   */
+  std::size_t inFlight() const {
+    return inFlight_.load(std::memory_order_relaxed);
+  }
+
+private:
+  /**
+   * @brief Max number of messages in flight for each level.
+   */
+  std::array<std::size_t, 4> limits_;
+
+  /**
+   * @brief Overload policy.
+   */
+  const OverloadPolicy policy_;
+
+  /**
+   * @brief Min time between two drop reports.
+   */
+  const std::chrono::milliseconds reportInterval_;
+
+  /**
+   * @brief Number of messages in flight.
+   */
+  std::atomic<std::size_t> inFlight_{0};
+
+  /**
+   * @brief Messages dropped since the last report, per level.
+   */
+  std::array<std::atomic<std::uint64_t>, 4> dropped_{};
+
+  /**
+   * @brief True while the report timer runs.
+   */
+  std::atomic<bool> reportArmed_{false};
+
+  /**
+   * @brief Time of the last report.
+   */
+  std::chrono::steady_clock::time_point lastReport_{};
+
+  /**
+   * @brief Serializes the reports.
+   */
+  std::mutex reportMtx_;
+
+  /**
+   * @brief Number of blocked producers.
+   */
+  std::atomic<int> waiting_{0};
+
+  /**
+   * @brief Mutex and condition of the blocked producers.
+   */
+  std::mutex mtx_;
+  std::condition_variable cv_;
+
+  /**
+   * @brief Takes a slot if fewer than 'limit' messages are in flight.
+   */
+  bool tryAcquire(std::size_t limit);
+}; // class OverloadGuard
+
+} // namespace helios::logger
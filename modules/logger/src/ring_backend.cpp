@@ -0,0 +1,147 @@
+#include "ring_backend.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief ID of the next backend.
+ */
+std::atomic<std::uint64_t> nextId{0};
+
+} // namespace
+
+namespace helios::logger {
+
+struct RingBackend::ThreadRings {
+  /**
+   * @brief Destructor. Hands the rings over to their consumers.
+   */
+  ~ThreadRings() {
+    for (auto &[id, ring] : rings)
+      ring->orphaned.store(true, std::memory_order_release);
+  }
+
+  /**
+   * @brief Pairs of backend ID and the ring of the calling thread.
+   */
+  std::vector<std::pair<std::uint64_t, std::shared_ptr<Ring>>> rings;
+}; // struct RingBackend::ThreadRings
+
+RingBackend::RingBackend(std::size_t capacity, Consumer consumer)
+    : id_{++nextId}, capacity_{capacity}, consumer_{std::move(consumer)} {
+  t_ = std::thread([this] { run(); }); // Start consumer thread
+}
+
+RingBackend::~RingBackend() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true; // Stop the consumer thread
+  }
+  cv_.notify_one(); // Wake the consumer thread
+  t_.join();        // Wait for the queued messages to be consumed
+}
+
+void RingBackend::push(LogMessage msg) {
+  Ring &r = ring();
+  while (!r.queue.tryPush(std::move(msg))) {
+    // Ring is full, let the consumer catch up
+    wake();
+    std::this_thread::yield();
+  }
+  wake();
+}
+
+RingBackend::Ring &RingBackend::ring() {
+  thread_local ThreadRings threadRings;
+  for (auto &[id, ring] : threadRings.rings) {
+    if (id == id_)
+      return *ring;
+  }
+
+  // First message of this thread, register a new ring
+  auto ring = std::make_shared<Ring>(capacity_);
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    rings_.push_back(ring);
+  }
+  threadRings.rings.emplace_back(id_, ring);
+  return *ring;
+}
+
+void RingBackend::wake() {
+  // Pairs with the fence of the consumer going to sleep: either the consumer
+  // sees the pushed message or this sees it sleeping
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!sleeping_.load(std::memory_order_relaxed))
+    return; // Busy, it drains the rings before sleeping again
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    woken_ = true;
+  }
+  cv_.notify_one();
+}
+
+void RingBackend::run() {
+  while (true) {
+    if (drain() > 0)
+      continue;
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (stop_)
+      break;
+
+    // Announce the sleep, then look at the rings once more so that a
+    // message pushed before the announcement is not missed
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!hasPending()) {
+      // Sleep until a producer wakes the thread
+      cv_.wait(lock, [this] { return woken_ || stop_; });
+    }
+    woken_ = false;
+    sleeping_.store(false, std::memory_order_relaxed);
+  }
+  drain(); // Consume the messages queued before stopping
+}
+
+bool RingBackend::hasPending() const {
+  for (const auto &ring : rings_) {
+    if (ring->queue.size() > 0)
+      return true;
+  }
+  return false;
+}
+
+std::size_t RingBackend::drain() {
+  std::vector<std::shared_ptr<Ring>> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    snapshot = rings_;
+  }
+
+  std::size_t count{0};
+  LogMessage msg;
+  for (auto &ring : snapshot) {
+    // Read before draining so that no message is pushed after the last pop
+    const bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+
+    // Pop at most one ring's worth so that a busy thread can't starve others
+    for (std::size_t i{}; i < ring->queue.capacity(); ++i) {
+      if (!ring->queue.tryPop(msg))
+        break;
+      consumer_(std::move(msg));
+      ++count;
+    }
+
+    if (orphaned && ring->queue.size() == 0) {
+      std::lock_guard<std::mutex> lock(mtx_);
+      rings_.erase(std::remove(rings_.begin(), rings_.end(), ring),
+                   rings_.end());
+    }
+  }
+  return count;
+}
+
+} // namespace helios::logger
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "log_message.hpp"
+#include "spsc_ring.hpp"
+
+namespace helios::logger {
+
+/**
+ * @class logger::RingBackend
+ *
+ * @brief Moves log messages from the producing threads to one consumer thread
+ *        without locks on the producer side.
+ *
+ * @details
+ * - Each producing thread gets its own SPSC ring on its first push.
+ * - A single consumer thread drains all the rings and hands every message to
+ *   the consumer callback.
+ * - The order of the messages of one thread is kept. Messages of different
+ *   threads may interleave in any order.
+ * - A producer blocks while its ring is full.
+ * - During destruction, all the queued messages are consumed first.
+ *
+ * @note
+ * - push() is thread-safe.
+ */
+class RingBackend {
+public:
+  /**
+   * @brief Type alias for the consumer callback.
+   */
+  using Consumer = std::function<void(LogMessage)>;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param capacity Capacity of the ring of each producing thread.
+   * @param consumer Called from the consumer thread for every message.
+   */
+  RingBackend(std::size_t capacity, Consumer consumer);
+
+  /**
+   * @brief Destructor.
+   *
+   * @note
+   * - Blocks until all the queued messages are consumed.
+   */
+  ~RingBackend();
+
+  /**
+   * @brief Delete copy and move semantics.
+   */
+  RingBackend(const RingBackend &) = delete;
+  RingBackend &operator=(const RingBackend &) = delete;
+  RingBackend(RingBackend &&) = delete;
+  RingBackend &operator=(RingBackend &&) = delete;
+
+  /**
+   * @brief Queues a message into the ring of the calling thread.
+   *
+   * @param msg Message to be queued.
+   */
+  void push(LogMessage msg);
+
+private:
+  /**
+   * @brief Ring of one producing thread.
+   */
+  struct Ring {
+    explicit Ring(std::size_t capacity) : queue{capacity} {}
+
+    /**
+     * @brief Queued messages.
+     */
+    SpscRing<LogMessage> queue;
+
+    /**
+     * @brief Set when the producing thread exits.
+     */
+    std::atomic<bool> orphaned{false};
+  }; // struct Ring
+
+  /**
+   * @brief Rings of the calling thread, one per backend.
+   */
+  struct ThreadRings;
+
+  /**
+   * @brief Identifies this backend in the rings of the producing threads.
+   */
+  const std::uint64_t id_;
+
+  /**
+   * @brief Capacity of each ring.
+   */
+  const std::size_t capacity_;
+
+  /**
+   * @brief Called for every consumed message.
+   */
+  Consumer consumer_;
+
+  /**
+   * @brief Rings of all the producing threads.
+   */
+  std::vector<std::shared_ptr<Ring>> rings_;
+
+  /**
+   * @brief Protects 'rings_', 'woken_' and 'stop_'. Producers only take it
+   *        to wake the sleeping consumer.
+   */
+  std::mutex mtx_;
+
+  /**
+   * @brief Wakes the consumer thread.
+   */
+  std::condition_variable cv_;
+
+  /**
+   * @brief True while the consumer thread sleeps or is about to.
+   */
+  std::atomic<bool> sleeping_{false};
+
+  /**
+   * @brief Set by a producer waking the consumer thread.
+   */
+  bool woken_{false};
+
+  /**
+   * @brief Set to true to stop the consumer thread.
+   */
+  bool stop_{false};
+
+  /**
+   * @brief Consumer thread.
+   */
+  std::thread t_;
+
+  /**
+   * @brief Returns the ring of the calling thread, creating it if needed.
+   */
+  Ring &ring();
+
+  /**
+   * @brief Wakes the consumer thread if it sleeps.
+   */
+  void wake();
+
+  /**
+   * @brief Function that runs in the consumer thread.
+   */
+  void run();
+
+  /**
+   * @brief Returns true if a ring holds messages. Called with 'mtx_' held.
+   */
+  bool hasPending() const;
+
+  /**
+   * @brief Consumes all the queued messages.
+   *
+   * @return Number of consumed messages.
+   */
+  std::size_t drain();
+}; // class RingBackend
+
+} // namespace helios::logger
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace helios::logger {
+
+/**
+ * @class logger::SpscRing
+ *
+ * @brief Bounded lock-free queue for one producer and one consumer thread.
+ *
+ * @tparam T Type of the queued elements.
+ *
+ * @details
+ * - The capacity is rounded up to a power of two.
+ * - The producer and consumer indices live on separate cache lines.
+ *
+ * @note
+ * - tryPush() shall only be called from the producer thread.
+ * - tryPop() shall only be called from the consumer thread.
+ */
+template <typename T> class SpscRing {
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param capacity Min number of elements the ring can hold.
+   */
+  explicit SpscRing(std::size_t capacity)
+      : mask_{roundUp(capacity) - 1},
+        slots_{std::make_unique<T[]>(mask_ + 1)} {}
+
+  /**
+   * @brief Delete copy and move semantics.
+   */
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+  SpscRing(SpscRing &&) = delete;
+  SpscRing &operator=(SpscRing &&) = delete;
+
+  /**
+   * @brief Pushes an element if the ring is not full.
+   *
+   * @param value Element to be pushed. Left untouched if the ring is full.
+   *
+   * @return True if the element is pushed, false if the ring is full.
+   */
+  bool tryPush(T &&value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cachedHead_ > mask_) {
+      cachedHead_ = head_.load(std::memory_order_acquire);
+      if (tail - cachedHead_ > mask_)
+        return false;
+    }
+    slots_[tail & mask_] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pops an element if the ring is not empty.
+   *
+   * @param value Receives the popped element.
+   *
+   * @return True if an element is popped, false if the ring is empty.
+   */
+  bool tryPop(T &value) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cachedTail_) {
+      cachedTail_ = tail_.load(std::memory_order_acquire);
+      if (head == cachedTail_)
+        return false;
+    }
+    value = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Returns the approximate number of queued elements.
+   */
+  std::size_t size() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Returns the number of elements the ring can hold.
+   */
+  std::size_t capacity() const { return mask_ + 1; }
+
+private:
+  /**
+   * @brief Size of a cache line.
+   */
+  static constexpr std::size_t CACHE_LINE = 64;
+
+  /**
+   * @brief Rounds up to the next power of two.
+   */
+  static std::size_t roundUp(std::size_t n) {
+    std::size_t p{1};
+    while (p < n)
+      p <<= 1;
+    return p;
+  }
+
+  /**
+   * @brief Capacity minus one.
+   */
+  const std::size_t mask_;
+
+  /**
+   * @brief Ring slots.
+   */
+  std::unique_ptr<T[]> slots_;
+
+  /**
+   * @brief Index of the next element to pop. Written by the consumer.
+   */
+  alignas(CACHE_LINE) std::atomic<std::size_t> head_{0};
+
+  /**
+   * @brief Consumer's copy of 'tail_' to avoid touching the producer's line.
+   */
+  std::size_t cachedTail_{0};
+
+  /**
+   * @brief Index of the next slot to push to. Written by the producer.
+   */
+  alignas(CACHE_LINE) std::atomic<std::size_t> tail_{0};
+
+  /**
+   * @brief Producer's copy of 'head_' to avoid touching the consumer's line.
+   */
+  std::size_t cachedHead_{0};
+}; // class SpscRing
+
+} // namespace helios::logger
@@ -1,30 +1,35 @@
 #include "standard_output_sink.hpp"
 
-#include <iostream>
+#include <unistd.h>
 
+#include "log_formatter.hpp"
 #include "log_message.hpp"
 
-namespace {
-
-/**
- * @brief Writes a string to the standard output.
- *
- * @param s String to be written.
- */
-void write(const std::string &s) {
-  std::cout << s;
-  std::cout.flush();
-}
-
-} // namespace
-
 namespace helios::logger {
 
 StandardOutputSink::StandardOutputSink(
-    std::shared_ptr<core::HLoop> loop, std::shared_ptr<core::HBus> hBus
+    std::shared_ptr<core::HLoop> loop, std::shared_ptr<core::HBus> hBus,
+    FlushPolicy policy, OutputFormat format
 )
-    : InActiveHObject{loop, hBus} {
-  LISTEN(LogMessage, { write(sig->msg); });
+    : InActiveHObject{loop, hBus}, format_{format},
+      writer_{STDOUT_FILENO, false, policy} {
+  LISTEN(LogMessage, {
+    writer_.append(formatMessage(*sig, format_), sig->level);
+  });
+  if (writer_.interval().count() > 0)
+    scheduleFlush();
+}
+
+StandardOutputSink::~StandardOutputSink() {
+  cancelTimers(); // The flush timer uses the writer
+  drain();
+}
+
+void StandardOutputSink::scheduleFlush() {
+  postAfter(writer_.interval(), [this] {
+    writer_.flush();
+    scheduleFlush();
+  });
 }
 
 } // namespace helios::logger
@@ -4,15 +4,24 @@
 
 #include <core/in_active_h_object.hpp>
 
+#include "buffered_writer.hpp"
+#include "log_config.hpp"
+
 namespace helios::logger {
 
 /**
  * @class logger::StandardOutputSink
  *
- * @brief Takes a message and outputs it to the std::cout.
+ * @brief Takes a message and outputs it to the standard output.
  *
  * @details
  * - Does not make any modifications to the message, not even adding a new line.
+ * - Messages are written in batches according to the flush policy, bypassing
+ *   std::cout. The interval flushes run on the loop.
+ * - Since the text goes to file descriptor 1 directly, it is not ordered with
+ *   the text the application buffers in std::cout. Applications that print
+ *   to both flush std::cout before logging, or use a file sink instead.
+ * - Messages are rendered in the given output format.
  */
 class StandardOutputSink : public core::InActiveHObject {
 public:
@@ -20,15 +29,38 @@ public:
    * @brief Constructor.
    *
    * @param hBus Bus used for log messages.
+   * @param policy Flush policy.
+   * @param format Output format.
    */
   StandardOutputSink(
-      std::shared_ptr<core::HLoop> loop, std::shared_ptr<core::HBus> hBus
+      std::shared_ptr<core::HLoop> loop, std::shared_ptr<core::HBus> hBus,
+      FlushPolicy policy = {}, OutputFormat format = LOG_STDOUT_FORMAT
   );
 
   /**
-   * @brief Default virtual destructor.
+   * @brief Virtual destructor.
+   *
+   * @note
+   * - Blocks until the queued messages are written.
+   */
+  ~StandardOutputSink() override;
+
+private:
+  /**
+   * @brief Output format.
+   */
+  const OutputFormat format_;
+
+  /**
+   * @brief Buffered writer of the standard output.
+   */
+  BufferedWriter writer_;
+
+  /**
+   * @brief Flushes the writer after an interval of the flush policy and
+   *        schedules the next flush.
    */
-  ~StandardOutputSink() override = default;
+  void scheduleFlush();
 }; // class StandardOutputSink
 
 } // namespace helios::logger
@@ -0,0 +1,198 @@
+#include "binary_format.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <core/h_bus.hpp>
+#include <core/h_loop.hpp>
+
+#include "binary_sink.hpp"
+#include "log_formatter.hpp"
+
+namespace {
+
+using namespace helios::logger;
+
+/**
+ * @brief Builds a deferred message like Logger::logf() does.
+ */
+template <typename... Args>
+LogMessage deferred(LogLevel lvl, const std::string &tag, const char *fmt,
+                    const Args &...args) {
+  LogMessage msg;
+  msg.level = lvl;
+  msg.timestamp = std::chrono::system_clock::now();
+  msg.tag = std::make_shared<const std::string>(tag);
+  msg.format = {fmt, ARG_TYPES<Args...>, sizeof...(Args)};
+  (msg.args.append(args), ...);
+  return msg;
+}
+
+/**
+ * @brief Builds a streamed message.
+ */
+LogMessage streamed(LogLevel lvl, const std::string &tag, std::string body) {
+  LogMessage msg;
+  msg.level = lvl;
+  msg.timestamp = std::chrono::system_clock::now();
+  msg.tag = std::make_shared<const std::string>(tag);
+  msg.body = std::move(body);
+  return msg;
+}
+
+/**
+ * @brief Encodes messages into a binary file image.
+ */
+std::string encodeAll(const std::vector<LogMessage> &messages) {
+  std::string out;
+  BinaryEncoder::writeHeader(out);
+  BinaryEncoder encoder;
+  for (const auto &msg : messages)
+    encoder.encode(msg, out);
+  return out;
+}
+
+/**
+ * @brief Decodes a binary file image into text.
+ */
+std::vector<std::string> decodeAll(const std::string &image,
+                                   RecordFilter filter = {}) {
+  std::istringstream in(image);
+  BinaryDecoder decoder(in, std::move(filter));
+  std::vector<std::string> texts;
+  LogMessage msg;
+  while (decoder.next(msg))
+    texts.push_back(formatText(msg));
+  return texts;
+}
+
+} // namespace
+
+/**
+ * @brief Decoded messages render exactly like the original ones.
+ */
+TEST(BinaryFormatTest, RoundTrip) {
+  const char *fmt = "values {} {} {} {} {} {}";
+  const std::vector<LogMessage> messages{
+      deferred(LogLevel::Info, "A", fmt, true, 'c', -12345, 42u, 1.5,
+               "text"),
+      streamed(LogLevel::Warning, "B", "streamed body\n"),
+      deferred(LogLevel::Error, "A", fmt, false, 'd', 7, 0u, -2.25, ""),
+  };
+  const auto texts = decodeAll(encodeAll(messages));
+  ASSERT_EQ(texts.size(), messages.size());
+  for (std::size_t i{}; i < messages.size(); ++i)
+    EXPECT_EQ(texts[i], formatText(messages[i]));
+}
+
+/**
+ * @brief Structured messages keep their fields.
+ */
+TEST(BinaryFormatTest, StructuredRoundTrip) {
+  LogMessage msg = streamed(LogLevel::Info, "S", "");
+  msg.format = {"structured", ARG_TYPES<int, const char *>, 2, true};
+  msg.args.appendField("id", 7);
+  msg.args.appendField("name", "value");
+  const std::string image = encodeAll({msg});
+
+  std::istringstream in(image);
+  BinaryDecoder decoder(in);
+  LogMessage decoded;
+  ASSERT_TRUE(decoder.next(decoded));
+  EXPECT_TRUE(decoded.format.structured);
+  EXPECT_EQ(formatJson(decoded), formatJson(msg));
+}
+
+/**
+ * @brief Messages are filtered by level, tag and time.
+ */
+TEST(BinaryFormatTest, Filters) {
+  std::vector<LogMessage> messages{
+      streamed(LogLevel::Debug, "A", "1\n"),
+      streamed(LogLevel::Error, "B", "2\n"),
+      deferred(LogLevel::Warning, "A", "{}", 3),
+  };
+  messages[0].timestamp -= std::chrono::hours(1);
+  const std::string image = encodeAll(messages);
+
+  RecordFilter byLevel;
+  byLevel.minLevel = LogLevel::Warning;
+  EXPECT_EQ(decodeAll(image, byLevel).size(), 2u);
+
+  RecordFilter byTag;
+  byTag.tags = {"A"};
+  const auto tagged = decodeAll(image, byTag);
+  ASSERT_EQ(tagged.size(), 2u);
+  EXPECT_EQ(tagged[1], formatText(messages[2]));
+
+  RecordFilter byTime;
+  byTime.from = messages[1].timestamp - std::chrono::minutes(1);
+  EXPECT_EQ(decodeAll(image, byTime).size(), 2u);
+}
+
+/**
+ * @brief Streams that are not binary log files are rejected.
+ */
+TEST(BinaryFormatTest, RejectsOtherFiles) {
+  std::istringstream in("[2024-01-01 00:00:00] [INFO]  [A] text\n");
+  EXPECT_THROW(BinaryDecoder decoder(in), std::runtime_error);
+}
+
+/**
+ * @brief A truncated trailing record is not counted as complete.
+ *
+ * @details
+ * - The records before it shall still be counted.
+ */
+TEST(BinaryFormatTest, CompleteLengthStopsBeforeTruncatedRecord) {
+  const auto first = streamed(LogLevel::Info, "A", "first\n");
+  const auto second = streamed(LogLevel::Info, "A", "second\n");
+  const std::string image = encodeAll({first, second});
+  const std::string head = encodeAll({first});
+
+  std::istringstream whole(image);
+  EXPECT_EQ(completeLength(whole), image.size());
+  std::istringstream cut(image.substr(0, image.size() - 3));
+  EXPECT_EQ(completeLength(cut), head.size());
+  std::istringstream other("not a log file");
+  EXPECT_EQ(completeLength(other), 0u);
+}
+
+/**
+ * @brief A file of another format or version at the path of a BinarySink is
+ *        moved aside instead of being overwritten.
+ */
+TEST(BinarySinkTest, OtherFileIsMovedAside) {
+  namespace fs = std::filesystem;
+  const fs::path dir = fs::temp_directory_path() / "helios_binary_sink_aside";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  const fs::path path = dir / "app.hlog";
+  std::ofstream(path) << "not a log file";
+  {
+    auto loop = std::make_shared<helios::core::HLoop>();
+    BinarySink sink(loop, std::make_shared<helios::core::HBus>(),
+                    path.string());
+  }
+
+  std::vector<fs::path> files;
+  for (const auto &entry : fs::directory_iterator(dir))
+    files.push_back(entry.path());
+  ASSERT_EQ(files.size(), 2u);
+  for (const auto &file : files) {
+    std::ifstream in(file, std::ios::binary);
+    if (file == path) {
+      EXPECT_GT(completeLength(in), 0u);
+    } else {
+      EXPECT_EQ(file.extension(), ".old");
+      EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in), {}),
+                "not a log file");
+    }
+  }
+  fs::remove_all(dir);
+}
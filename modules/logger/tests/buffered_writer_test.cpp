@@ -0,0 +1,124 @@
+#include "buffered_writer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using helios::logger::BufferedWriter;
+using helios::logger::FlushPolicy;
+using helios::logger::LogLevel;
+
+/**
+ * @brief Temporary file removed at the end of the test.
+ */
+class TempFile {
+public:
+  TempFile() {
+    char path[] = "/tmp/helios_buffered_writer_XXXXXX";
+    fd_ = ::mkstemp(path);
+    path_ = path;
+  }
+
+  ~TempFile() {
+    ::close(fd_);
+    ::unlink(path_.c_str());
+  }
+
+  /**
+   * @brief Returns a new file descriptor appending to the file.
+   */
+  int open() const { return ::open(path_.c_str(), O_WRONLY | O_APPEND); }
+
+  /**
+   * @brief Returns the content of the file.
+   */
+  std::string read() const {
+    std::string content;
+    char buf[4096];
+    ssize_t n;
+    ::lseek(fd_, 0, SEEK_SET);
+    while ((n = ::read(fd_, buf, sizeof(buf))) > 0)
+      content.append(buf, static_cast<std::size_t>(n));
+    return content;
+  }
+
+private:
+  int fd_;
+  std::string path_;
+}; // class TempFile
+
+/**
+ * @brief Policy that only writes full buffers.
+ */
+FlushPolicy manualPolicy() {
+  FlushPolicy policy;
+  policy.bufferSize = 64;
+  policy.everyMessages = 0;
+  policy.interval = std::chrono::milliseconds(0);
+  policy.flushLevel = LogLevel::Error;
+  policy.fsync = false;
+  return policy;
+}
+
+} // namespace
+
+/**
+ * @brief Messages are written every N messages and on the flush level.
+ */
+TEST(BufferedWriterTest, FlushesEveryNAndOnLevel) {
+  TempFile file;
+  FlushPolicy policy = manualPolicy();
+  policy.everyMessages = 3;
+  BufferedWriter writer(file.open(), true, policy);
+
+  writer.append("a", LogLevel::Info);
+  writer.append("b", LogLevel::Info);
+  EXPECT_EQ(file.read(), "");
+  writer.append("c", LogLevel::Info);
+  EXPECT_EQ(file.read(), "abc");
+
+  writer.append("d", LogLevel::Info);
+  writer.append("e", LogLevel::Error);
+  EXPECT_EQ(file.read(), "abcde");
+}
+
+/**
+ * @brief A message that does not fit is written with the buffer at once, and
+ *        the destructor writes the rest.
+ */
+TEST(BufferedWriterTest, FullBufferAndDestructor) {
+  TempFile file;
+  {
+    BufferedWriter writer(file.open(), true, manualPolicy());
+    writer.append("head", LogLevel::Info);
+    const std::string large(100, 'x');
+    writer.append(large, LogLevel::Info);
+    EXPECT_EQ(file.read(), "head" + large);
+    writer.append("tail", LogLevel::Info);
+    EXPECT_EQ(file.read(), "head" + large);
+  }
+  EXPECT_EQ(file.read(), "head" + std::string(100, 'x') + "tail");
+}
+
+/**
+ * @brief The writer never writes by itself, the interval is left to its
+ *        owner.
+ */
+TEST(BufferedWriterTest, IntervalIsLeftToOwner) {
+  TempFile file;
+  FlushPolicy policy = manualPolicy();
+  policy.interval = std::chrono::milliseconds(10);
+  BufferedWriter writer(file.open(), true, policy);
+  EXPECT_EQ(writer.interval(), std::chrono::milliseconds(10));
+
+  writer.append("a", LogLevel::Info);
+  EXPECT_EQ(file.read(), "");
+  writer.flush();
+  EXPECT_EQ(file.read(), "a");
+}
@@ -0,0 +1,154 @@
+#include "file_sink.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <core/h_bus.hpp>
+#include <core/h_loop.hpp>
+
+#include "log_message.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Returns the content of a file.
+ */
+std::string contentOf(const fs::path &path) {
+  std::ifstream in(path);
+  return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+/**
+ * @brief Returns the names of the files in a directory.
+ */
+std::vector<std::string> filesIn(const fs::path &dir) {
+  std::vector<std::string> names;
+  for (const auto &entry : fs::directory_iterator(dir))
+    names.push_back(entry.path().filename().string());
+  return names;
+}
+
+} // namespace
+
+/**
+ * @brief The file is rotated by size and only the newest rotated files are
+ *        kept.
+ *
+ * @details
+ * - Rotated files shall be compressed if zlib is available.
+ */
+TEST(FileSinkTest, RotatesBySizeWithRetention) {
+  using namespace helios;
+  const fs::path dir = fs::temp_directory_path() / "helios_file_sink_test";
+  fs::remove_all(dir);
+  const std::string path = (dir / "app.log").string();
+
+  auto loop = std::make_shared<core::HLoop>();
+  auto bus = std::make_shared<core::HBus>();
+  logger::FlushPolicy policy;
+  policy.interval = std::chrono::milliseconds(0);
+  logger::RotationPolicy rotation;
+  rotation.maxSize = 200;
+  rotation.interval = std::chrono::seconds(0);
+  rotation.keep = 2;
+  {
+    logger::FileSink sink(loop, bus, path, policy, rotation);
+    for (int i{}; i < 30; ++i) {
+      logger::LogMessage msg;
+      msg.level = logger::LogLevel::Info;
+      msg.timestamp = std::chrono::system_clock::now();
+      msg.body = "message number " + std::to_string(i) + "\n";
+      bus->publish<logger::LogMessage>(std::move(msg));
+    }
+  }
+
+  const auto names = filesIn(dir);
+  EXPECT_EQ(names.size(), 3u);
+  EXPECT_TRUE(fs::exists(path));
+  EXPECT_LE(fs::file_size(path), rotation.maxSize);
+  for (const auto &name : names) {
+    if (name == "app.log")
+      continue;
+    EXPECT_EQ(name.rfind("app.log.", 0), 0u);
+    if (logger::ENABLE_ROTATE_COMPRESS) {
+      EXPECT_EQ(name.substr(name.size() - 3), ".gz");
+    }
+  }
+  fs::remove_all(dir);
+}
+
+/**
+ * @brief Buffered messages are written by the interval flushes of the loop.
+ */
+TEST(FileSinkTest, FlushesOnInterval) {
+  using namespace helios;
+  const fs::path dir = fs::temp_directory_path() / "helios_file_sink_flush";
+  fs::remove_all(dir);
+  const std::string path = (dir / "app.log").string();
+
+  auto loop = std::make_shared<core::HLoop>();
+  auto bus = std::make_shared<core::HBus>();
+  logger::FlushPolicy policy;
+  policy.everyMessages = 0;
+  policy.interval = std::chrono::milliseconds(10);
+  policy.flushLevel = logger::LogLevel::Error;
+  logger::RotationPolicy rotation;
+  rotation.maxSize = 0;
+  rotation.interval = std::chrono::seconds(0);
+  {
+    logger::FileSink sink(loop, bus, path, policy, rotation);
+    logger::LogMessage msg;
+    msg.level = logger::LogLevel::Info;
+    msg.body = "flushed\n";
+    bus->publish<logger::LogMessage>(std::move(msg));
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (contentOf(path).empty() &&
+           std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    const std::string content = contentOf(path);
+    EXPECT_NE(content.find("flushed\n"), std::string::npos);
+  }
+  fs::remove_all(dir);
+}
+
+/**
+ * @brief An idle sink rotates its file by time.
+ */
+TEST(FileSinkTest, RotatesByTimeWhenIdle) {
+  using namespace helios;
+  const fs::path dir = fs::temp_directory_path() / "helios_file_sink_idle";
+  fs::remove_all(dir);
+  const std::string path = (dir / "app.log").string();
+
+  auto loop = std::make_shared<core::HLoop>();
+  auto bus = std::make_shared<core::HBus>();
+  logger::FlushPolicy policy;
+  policy.interval = std::chrono::milliseconds(0);
+  logger::RotationPolicy rotation;
+  rotation.maxSize = 0;
+  rotation.interval = std::chrono::seconds(1);
+  rotation.keep = 0;
+  rotation.compress = false;
+  {
+    logger::FileSink sink(loop, bus, path, policy, rotation);
+    logger::LogMessage msg;
+    msg.level = logger::LogLevel::Info;
+    msg.body = "before rotation\n";
+    bus->publish<logger::LogMessage>(std::move(msg));
+    // Nothing is logged anymore, the rotation comes from the loop
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (filesIn(dir).size() < 2 &&
+           std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(filesIn(dir).size(), 2u);
+  }
+  fs::remove_all(dir);
+}
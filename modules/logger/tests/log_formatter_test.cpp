@@ -0,0 +1,199 @@
+#include "log_formatter.hpp"
+
+#include <gtest/gtest.h>
+
+#include "log_config.hpp"
+
+namespace {
+
+/**
+ * @brief Creates a deferred message.
+ */
+template <std::size_t N, typename... Args>
+helios::logger::LogMessage deferred(const char (&fmt)[N],
+                                    const Args &...args) {
+  helios::logger::LogMessage msg;
+  msg.level = helios::logger::LogLevel::Info;
+  msg.tag = std::make_shared<const std::string>("Tag");
+  msg.format = {fmt, helios::logger::ARG_TYPES<Args...>, sizeof...(Args)};
+  (msg.args.append(args), ...);
+  return msg;
+}
+
+/**
+ * @brief Returns true if 's' ends with 'suffix'.
+ */
+bool endsWith(const std::string &s, const std::string &suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+/**
+ * @brief A streamed message keeps its body.
+ */
+TEST(LogFormatterTest, StreamedMessage) {
+  helios::logger::LogMessage msg;
+  msg.level = helios::logger::LogLevel::Debug;
+  msg.tag = std::make_shared<const std::string>("Tag");
+  msg.body = "Streamed\n";
+  EXPECT_TRUE(endsWith(helios::logger::formatText(msg),
+                       "] [DEBUG] [Tag] Streamed\n"));
+}
+
+/**
+ * @brief The arguments of a deferred message replace the placeholders.
+ */
+TEST(LogFormatterTest, DeferredMessage) {
+  auto msg = deferred("i={} u={} d={} b={} c={} s={} e={}", -3, 7u, 0.5, true,
+                      'x', std::string("str"), "lit");
+  EXPECT_TRUE(endsWith(helios::logger::formatText(msg),
+                       "] [INFO]  [Tag] i=-3 u=7 d=0.5 b=true c=x s=str "
+                       "e=lit\n"));
+}
+
+/**
+ * @brief A null C string argument is printed as "(null)".
+ */
+TEST(LogFormatterTest, DeferredMessageNullString) {
+  const char *none = nullptr;
+  auto msg = deferred("s={}", none);
+  std::string body;
+  helios::logger::renderArgs(msg.format, msg.args, body);
+  EXPECT_EQ(body, "s=(null)");
+}
+
+/**
+ * @brief Long strings are truncated to fit the argument bytes.
+ */
+TEST(LogFormatterTest, DeferredMessageTruncatesLongStrings) {
+  std::string longString(1000, 'a');
+  auto msg = deferred("{} {}", longString, 5);
+  std::string body;
+  helios::logger::renderArgs(msg.format, msg.args, body);
+  EXPECT_LT(body.size(), helios::logger::LogArgs::CAPACITY);
+  EXPECT_EQ(body.back(), ' '); // The second argument did not fit
+}
+
+/**
+ * @brief Time stamps of the same second share the cached date and time.
+ *
+ * @details
+ * - The sub-second digits shall match the requested precision, which
+ *   defaults to the configured one.
+ */
+TEST(LogFormatterTest, TimestampPrecision) {
+  using namespace std::chrono;
+  const auto second = floor<seconds>(system_clock::now());
+  const std::size_t dateTime = std::string("YYYY-mm-dd HH:MM:SS").size();
+  const auto render = [](system_clock::time_point tp, int decimals) {
+    std::string out;
+    helios::logger::appendTimestamp(tp, out, decimals);
+    return out;
+  };
+
+  const std::string first = render(second + milliseconds(1), 0);
+  const std::string last = render(second + milliseconds(999), 0);
+  EXPECT_EQ(first.size(), dateTime);
+  EXPECT_EQ(first, last);
+
+  const std::string millis = render(second + milliseconds(7), 3);
+  EXPECT_EQ(millis.substr(0, dateTime), first);
+  EXPECT_EQ(millis.substr(dateTime), ".007");
+  EXPECT_EQ(render(second + nanoseconds(123456789), 9).substr(dateTime),
+            ".123456789");
+  EXPECT_EQ(render(second + microseconds(999999), 6).substr(dateTime),
+            ".999999");
+
+  std::string configured;
+  helios::logger::appendTimestamp(second, configured);
+  EXPECT_EQ(configured.size(),
+            dateTime + (helios::logger::LOG_TIME_DECIMALS == 0
+                            ? 0
+                            : 1 + helios::logger::LOG_TIME_DECIMALS));
+}
+
+namespace {
+
+/**
+ * @brief Creates a structured message like Logger::infoKv() does.
+ */
+helios::logger::LogMessage structured() {
+  using namespace helios::logger;
+  LogMessage msg;
+  msg.level = LogLevel::Warning;
+  msg.tag = std::make_shared<const std::string>("Tag");
+  msg.format = {"Request \"done\"", ARG_TYPES<int, double, const char *>, 3,
+                true};
+  msg.args.appendField("id", 42);
+  msg.args.appendField("ratio", 0.5);
+  msg.args.appendField("path", "/a b\n");
+  return msg;
+}
+
+} // namespace
+
+/**
+ * @brief Structured fields render as JSON members, escaped where needed.
+ */
+TEST(LogFormatterTest, StructuredJson) {
+  using namespace helios::logger;
+  const std::string json = formatJson(structured());
+  EXPECT_EQ(json.rfind("{\"time\":\"", 0), 0u);
+  EXPECT_TRUE(endsWith(json, "\"level\":\"WARN\",\"tag\":\"Tag\","
+                             "\"msg\":\"Request \\\"done\\\"\",\"id\":42,"
+                             "\"ratio\":0.5,\"path\":\"/a b\\n\"}\n"));
+  EXPECT_EQ(formatMessage(structured(), OutputFormat::Json), json);
+}
+
+/**
+ * @brief Structured fields render as logfmt pairs, quoted where needed.
+ */
+TEST(LogFormatterTest, StructuredLogfmt) {
+  using namespace helios::logger;
+  const std::string line = formatLogfmt(structured());
+  EXPECT_EQ(line.rfind("time=\"", 0), 0u);
+  EXPECT_TRUE(endsWith(line, " level=WARN tag=Tag msg=\"Request \\\"done\\\"\" "
+                             "id=42 ratio=0.5 path=\"/a b\\n\"\n"));
+  EXPECT_TRUE(endsWith(formatText(structured()),
+                       "[Tag] Request \"done\" id=42 ratio=0.5 "
+                       "path=\"/a b\\n\"\n"));
+}
+
+/**
+ * @brief A field that doesn't fit is dropped as a whole with the later ones,
+ *        so no key or type is taken from another field.
+ */
+TEST(LogFormatterTest, StructuredFieldDroppedWhole) {
+  using namespace helios::logger;
+  LogMessage msg;
+  msg.level = LogLevel::Info;
+  msg.format = {"Fields", ARG_TYPES<const char *, int, char>, 3, true};
+  const std::string filler(LogArgs::CAPACITY - 16, 'f');
+  msg.args.appendField("a", filler.c_str());
+  msg.args.appendField("number", 42); // Needs 16 bytes, 13 are left
+  msg.args.appendField("c", 'x'); // Would fit
+  EXPECT_EQ(msg.args.count(), 1u);
+  EXPECT_TRUE(endsWith(formatLogfmt(msg), " a=" + filler + "\n"));
+}
+
+/**
+ * @brief Field keys never repeat the members of the message and stay valid
+ *        logfmt keys.
+ */
+TEST(LogFormatterTest, StructuredKeysAreEscaped) {
+  using namespace helios::logger;
+  LogMessage msg;
+  msg.level = LogLevel::Info;
+  msg.format = {"Keys", ARG_TYPES<int, int, int, int>, 4, true};
+  msg.args.appendField("time", 1);
+  msg.args.appendField("_time", 2);
+  msg.args.appendField("a b=\"c\"", 3);
+  msg.args.appendField("", 4);
+  EXPECT_TRUE(endsWith(formatJson(msg), "\"msg\":\"Keys\",\"_time\":1,"
+                                        "\"__time\":2,\"a b=\\\"c\\\"\":3,"
+                                        "\"_\":4}\n"));
+  EXPECT_TRUE(endsWith(formatLogfmt(msg),
+                       " msg=Keys _time=1 __time=2 a_b__c_=3 _=4\n"));
+}
@@ -43,3 +43,63 @@ TEST(LoggerTest, ErrMacros) {
   helios::logger::Logger logger_("LoggerTest");
   LOG_ERROR << "I am an error log by a macro";
 }
+
+TEST(LoggerTest, DeferredMacros) {
+  helios::logger::Logger logger_("LoggerTest");
+  LOGF_DEBUG("I am a deferred debug log");
+  LOGF_INFO("I am a deferred info log with {} and {}", 42, "a string");
+  LOGF_WARN("I am a deferred warning log with {}", 1.5);
+  LOGF_ERROR("I am a deferred error log with {}", true);
+}
+
+namespace {
+
+/**
+ * @brief Counts how many times a message is built.
+ */
+int built{0};
+
+int build() { return ++built; }
+
+} // namespace
+
+/**
+ * @brief Per-name thresholds override the global one at runtime.
+ *
+ * @details
+ * - A disabled statement shall not evaluate its message.
+ */
+TEST(LoggerTest, RuntimeLevels) {
+  using helios::logger::Logger;
+  using helios::logger::LogLevel;
+  Logger logger_("LevelTest");
+  Logger other("OtherLevelTest");
+
+  Logger::setLevel("LevelTest", LogLevel::Error);
+  EXPECT_FALSE(logger_.isEnabled(LogLevel::Warning));
+  EXPECT_TRUE(logger_.isEnabled(LogLevel::Error));
+  EXPECT_TRUE(other.isEnabled(LogLevel::Warning));
+
+  built = 0;
+  LOG_INFO << build();
+  LOGF_WARN("{}", build());
+  EXPECT_EQ(built, 0);
+  LOG_ERROR << "I am an error log with " << build();
+  EXPECT_EQ(built, 1);
+
+  Logger::setLevel(LogLevel::Error);
+  EXPECT_FALSE(other.isEnabled(LogLevel::Warning));
+  Logger::resetLevel("LevelTest");
+  Logger::setLevel(helios::logger::LOG_LEVEL_MIN);
+  EXPECT_TRUE(logger_.isEnabled(LogLevel::Warning));
+  EXPECT_TRUE(other.isEnabled(LogLevel::Warning));
+}
+
+TEST(LoggerTest, StructuredMacros) {
+  using helios::logger::kv;
+  helios::logger::Logger logger_("LoggerTest");
+  LOGKV_DEBUG("I am a structured debug log");
+  LOGKV_INFO("I am a structured info log", kv("id", 42), kv("name", "str"));
+  LOGKV_WARN("I am a structured warning log", kv("ratio", 1.5));
+  logger_.errorKv("I am a structured error log", kv("ok", false));
+}
@@ -0,0 +1,225 @@
+#include "mapped_sink.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "log_formatter.hpp"
+
+namespace {
+
+using namespace helios::logger;
+
+/**
+ * @brief Builds a streamed message.
+ */
+LogMessage message(int i) {
+  LogMessage msg;
+  msg.level = i % 2 ? LogLevel::Error : LogLevel::Info;
+  msg.timestamp = std::chrono::system_clock::now();
+  msg.tag = std::make_shared<const std::string>("MappedTest");
+  msg.body = "message " + std::to_string(i) + "\n";
+  return msg;
+}
+
+/**
+ * @brief Returns the sequence numbers and the rendered messages of a file.
+ */
+std::vector<std::pair<std::uint64_t, std::string>>
+readAll(const std::string &path, const RecordFilter &filter = {}) {
+  std::vector<std::pair<std::uint64_t, std::string>> records;
+  readMappedLog(path, filter, [&](std::uint64_t seq, const LogMessage &msg) {
+    records.emplace_back(seq, formatText(msg));
+  });
+  return records;
+}
+
+} // namespace
+
+/**
+ * @brief Written records are readable while the file is still mapped, as
+ *        after a crash, and the oldest ones are overwritten when full.
+ *
+ * @details
+ * - Verifies that the decoded messages render like the original ones.
+ */
+TEST(MappedSinkTest, RecordsSurviveAndWrap) {
+  namespace fs = std::filesystem;
+  const std::string path =
+      (fs::temp_directory_path() / "helios_mapped_sink_test.hmap").string();
+  fs::remove(path);
+
+  constexpr std::size_t SLOTS{8};
+  MappedSink sink(path, MappedSink::PREFIX_SIZE + SLOTS * 128, 128);
+  ASSERT_TRUE(sink.isOpen());
+  EXPECT_TRUE(isMappedLog(path));
+  const std::uint64_t tag = sink.tagId("MappedTest");
+  EXPECT_EQ(sink.tagId("MappedTest"), tag);
+
+  std::vector<LogMessage> written;
+  for (int i{}; i < 20; ++i) {
+    written.push_back(message(i));
+    sink.write(written.back(), tag);
+  }
+
+  const auto records = readAll(path);
+  ASSERT_EQ(records.size(), SLOTS);
+  for (std::size_t i{}; i < SLOTS; ++i) {
+    EXPECT_EQ(records[i].first, 20 - SLOTS + i + 1);
+    EXPECT_EQ(records[i].second, formatText(written[20 - SLOTS + i]));
+  }
+
+  RecordFilter errors;
+  errors.minLevel = LogLevel::Error;
+  EXPECT_EQ(readAll(path, errors).size(), SLOTS / 2);
+  RecordFilter otherTag;
+  otherTag.tags = {"Other"};
+  EXPECT_TRUE(readAll(path, otherTag).empty());
+  fs::remove(path);
+}
+
+/**
+ * @brief Deferred messages are stored with their raw arguments.
+ */
+TEST(MappedSinkTest, DeferredMessage) {
+  namespace fs = std::filesystem;
+  const std::string path =
+      (fs::temp_directory_path() / "helios_mapped_sink_deferred.hmap")
+          .string();
+  fs::remove(path);
+
+  MappedSink sink(path, MappedSink::PREFIX_SIZE + 8 * 256, 256);
+  LogMessage msg = message(0);
+  msg.body.clear();
+  static constexpr ArgType TYPES[] = {ArgType::Int, ArgType::String};
+  msg.format = {"value {} of {}\n", TYPES, 2};
+  msg.args.append(42);
+  msg.args.append("answer");
+  sink.write(msg, sink.tagId("MappedTest"));
+
+  const auto records = readAll(path);
+  ASSERT_EQ(records.size(), 1u);
+  EXPECT_EQ(records[0].second, formatText(msg));
+  EXPECT_NE(records[0].second.find("value 42 of answer"), std::string::npos);
+  fs::remove(path);
+}
+
+/**
+ * @brief A reopened file continues the sequence and the tags of the previous
+ *        run.
+ */
+TEST(MappedSinkTest, ContinuesExistingFile) {
+  namespace fs = std::filesystem;
+  const std::string path =
+      (fs::temp_directory_path() / "helios_mapped_sink_reopen.hmap").string();
+  fs::remove(path);
+  constexpr std::size_t SIZE{MappedSink::PREFIX_SIZE + 8 * 128};
+  std::uint64_t tag;
+  {
+    MappedSink sink(path, SIZE, 128);
+    tag = sink.tagId("MappedTest");
+    sink.write(message(0), tag);
+  }
+  {
+    MappedSink sink(path, SIZE, 128);
+    EXPECT_EQ(sink.tagId("MappedTest"), tag);
+    EXPECT_NE(sink.tagId("Other"), tag);
+    sink.write(message(1), tag);
+  }
+  const auto records = readAll(path);
+  ASSERT_EQ(records.size(), 2u);
+  EXPECT_EQ(records[1].first, 2u);
+
+  // Too long for a slot, the body is truncated
+  {
+    MappedSink sink(path, SIZE, 128);
+    LogMessage msg = message(2);
+    msg.body = std::string(1000, 'x');
+    sink.write(msg, tag);
+  }
+  const std::string text = readAll(path).back().second;
+  const auto body = text.substr(text.find("[MappedTest] ") + 13);
+  EXPECT_GT(body.size(), 64u);
+  EXPECT_LT(body.size(), 128u);
+  EXPECT_EQ(body, std::string(body.size(), 'x'));
+  fs::remove(path);
+}
+
+/**
+ * @brief A file of another layout is moved aside with its records instead of
+ *        being erased.
+ */
+TEST(MappedSinkTest, OtherLayoutIsMovedAside) {
+  namespace fs = std::filesystem;
+  const fs::path dir = fs::temp_directory_path() / "helios_mapped_sink_aside";
+  fs::remove_all(dir);
+  const std::string path = (dir / "crash.hmap").string();
+  {
+    MappedSink sink(path, MappedSink::PREFIX_SIZE + 8 * 128, 128);
+    sink.write(message(0), sink.tagId("MappedTest"));
+  }
+  {
+    MappedSink sink(path, MappedSink::PREFIX_SIZE + 16 * 128, 128);
+    ASSERT_TRUE(sink.isOpen());
+    sink.write(message(1), sink.tagId("MappedTest"));
+  }
+
+  std::vector<fs::path> files;
+  for (const auto &entry : fs::directory_iterator(dir))
+    files.push_back(entry.path());
+  ASSERT_EQ(files.size(), 2u);
+  for (const auto &file : files) {
+    const auto records = readAll(file.string());
+    ASSERT_EQ(records.size(), 1u);
+    const char *body =
+        file.extension() == ".old" ? "message 0\n" : "message 1\n";
+    EXPECT_NE(records[0].second.find(body), std::string::npos);
+  }
+  fs::remove_all(dir);
+}
+
+/**
+ * @brief A slot left busy, as by a crash while writing it, is skipped and
+ *        freed when the file is reopened.
+ */
+TEST(MappedSinkTest, BusySlotIsSkipped) {
+  namespace fs = std::filesystem;
+  const std::string path =
+      (fs::temp_directory_path() / "helios_mapped_sink_busy.hmap").string();
+  fs::remove(path);
+  constexpr std::size_t SIZE{MappedSink::PREFIX_SIZE + 8 * 128};
+  {
+    MappedSink sink(path, SIZE, 128);
+    const std::uint64_t tag = sink.tagId("MappedTest");
+    sink.write(message(0), tag);
+    sink.write(message(1), tag);
+  }
+  {
+    // Mark the first slot as being written
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekg(MappedSink::PREFIX_SIZE);
+    std::uint64_t seq{0};
+    file.read(reinterpret_cast<char *>(&seq), sizeof(seq));
+    ASSERT_EQ(seq, 1u);
+    seq |= std::uint64_t{1} << 63;
+    file.seekp(MappedSink::PREFIX_SIZE);
+    file.write(reinterpret_cast<const char *>(&seq), sizeof(seq));
+  }
+  auto records = readAll(path);
+  ASSERT_EQ(records.size(), 1u);
+  EXPECT_EQ(records[0].first, 2u);
+
+  {
+    MappedSink sink(path, SIZE, 128);
+    for (int i{2}; i < 9; ++i)
+      sink.write(message(i), sink.tagId("MappedTest"));
+  }
+  records = readAll(path);
+  ASSERT_EQ(records.size(), 8u);
+  EXPECT_EQ(records.front().first, 2u);
+  EXPECT_EQ(records.back().first, 9u);
+  fs::remove(path);
+}
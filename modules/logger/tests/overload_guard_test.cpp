@@ -0,0 +1,136 @@
+#include "overload_guard.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "log_formatter.hpp"
+
+using namespace helios::logger;
+using namespace std::chrono_literals;
+
+/**
+ * @brief New messages are dropped and counted while the queue is full.
+ */
+TEST(OverloadGuardTest, DropNewest) {
+  OverloadGuard guard(2, OverloadPolicy::DropNewest, 0ms);
+  EXPECT_TRUE(guard.admit(LogLevel::Debug));
+  EXPECT_TRUE(guard.admit(LogLevel::Debug));
+  EXPECT_FALSE(guard.admit(LogLevel::Error));
+  EXPECT_FALSE(guard.admit(LogLevel::Info));
+  EXPECT_EQ(guard.inFlight(), 2u);
+  guard.release();
+  EXPECT_TRUE(guard.admit(LogLevel::Info));
+
+  auto report = guard.takeReport(std::chrono::steady_clock::now());
+  ASSERT_TRUE(report.has_value());
+  EXPECT_EQ(report->level, LogLevel::Warning);
+  const std::string text = formatText(*report);
+  EXPECT_NE(text.find("dropped=2 debug=0 info=1 warning=0 error=1"),
+            std::string::npos)
+      << text;
+  EXPECT_FALSE(guard.takeReport(std::chrono::steady_clock::now()));
+}
+
+/**
+ * @brief Lower levels are dropped first and reports are rate limited.
+ */
+TEST(OverloadGuardTest, DropByLevel) {
+  OverloadGuard guard(10, OverloadPolicy::DropByLevel, 1h);
+  int debug{0};
+  while (guard.admit(LogLevel::Debug))
+    ++debug;
+  EXPECT_EQ(debug, 5);
+  EXPECT_TRUE(guard.admit(LogLevel::Info));
+  EXPECT_TRUE(guard.admit(LogLevel::Warning));
+  int error{0};
+  while (guard.admit(LogLevel::Error))
+    ++error;
+  EXPECT_EQ(error, 3);
+
+  const auto now = std::chrono::steady_clock::now();
+  EXPECT_TRUE(guard.takeReport(now));
+  guard.admit(LogLevel::Debug);
+  EXPECT_FALSE(guard.takeReport(now + 1min));
+  EXPECT_TRUE(guard.takeReport(now + 2h));
+}
+
+/**
+ * @brief Producers wait while the queue is full with the Block policy.
+ */
+TEST(OverloadGuardTest, Block) {
+  OverloadGuard guard(1, OverloadPolicy::Block, 0ms);
+  EXPECT_TRUE(guard.admit(LogLevel::Debug));
+  std::atomic<bool> admitted{false};
+  std::thread producer([&] {
+    admitted = guard.admit(LogLevel::Debug);
+  });
+  std::this_thread::sleep_for(50ms);
+  EXPECT_FALSE(admitted);
+  guard.release();
+  producer.join();
+  EXPECT_TRUE(admitted);
+  EXPECT_FALSE(guard.takeReport(std::chrono::steady_clock::now()));
+}
+
+/**
+ * @brief The Block policy drops instead of waiting where it may not block.
+ */
+TEST(OverloadGuardTest, BlockFallsBackToDrop) {
+  OverloadGuard guard(1, OverloadPolicy::Block, 0ms);
+  EXPECT_TRUE(guard.admit(LogLevel::Debug, false));
+  EXPECT_FALSE(guard.admit(LogLevel::Error, false));
+  const auto report = guard.takeReport(std::chrono::steady_clock::now());
+  ASSERT_TRUE(report.has_value());
+  EXPECT_NE(formatText(*report).find("dropped=1"), std::string::npos);
+}
+
+/**
+ * @brief A message releases its admission once when it is destroyed.
+ *
+ * @details
+ * - Verifies that copies do not release it again and moves carry it.
+ */
+TEST(OverloadGuardTest, AdmissionReleasedWithMessage) {
+  OverloadGuard guard(4, OverloadPolicy::DropNewest, 0ms);
+  ASSERT_TRUE(guard.admit(LogLevel::Info));
+  {
+    LogMessage msg;
+    msg.admission = Admission(&guard);
+    {
+      LogMessage copy = msg;
+    }
+    EXPECT_EQ(guard.inFlight(), 1u);
+    auto shared = std::make_shared<const LogMessage>(std::move(msg));
+    auto handler = shared;
+    shared.reset();
+    EXPECT_EQ(guard.inFlight(), 1u);
+  }
+  EXPECT_EQ(guard.inFlight(), 0u);
+}
+
+/**
+ * @brief The report is armed by the first drop and disarmed once a report
+ *        finds nothing.
+ *
+ * @details
+ * - A drop made while the report is being disarmed keeps it armed.
+ */
+TEST(OverloadGuardTest, ReportArmedByDrops) {
+  OverloadGuard guard(1, OverloadPolicy::DropNewest, 0ms);
+  EXPECT_TRUE(guard.admit(LogLevel::Info));
+  EXPECT_FALSE(guard.admit(LogLevel::Info));
+  EXPECT_TRUE(guard.armReport());
+  EXPECT_FALSE(guard.admit(LogLevel::Info));
+  EXPECT_FALSE(guard.armReport());
+
+  EXPECT_TRUE(guard.takeReport(std::chrono::steady_clock::now()));
+  EXPECT_FALSE(guard.takeReport(std::chrono::steady_clock::now()));
+  EXPECT_FALSE(guard.disarmReport());
+
+  EXPECT_FALSE(guard.admit(LogLevel::Info));
+  EXPECT_TRUE(guard.armReport());
+  EXPECT_TRUE(guard.disarmReport());
+  EXPECT_FALSE(guard.armReport());
+}
@@ -0,0 +1,73 @@
+#include "ring_backend.hpp"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Elements pushed to an SpscRing are popped in order until it is empty.
+ */
+TEST(SpscRingTest, PushPopInOrder) {
+  helios::logger::SpscRing<int> ring(3);
+  EXPECT_EQ(ring.capacity(), 4u);
+  for (int i{}; i < 4; ++i) {
+    int value{i};
+    EXPECT_TRUE(ring.tryPush(std::move(value)));
+  }
+  int full{4};
+  EXPECT_FALSE(ring.tryPush(std::move(full)));
+  for (int i{}; i < 4; ++i) {
+    int value{};
+    ASSERT_TRUE(ring.tryPop(value));
+    EXPECT_EQ(value, i);
+  }
+  int empty{};
+  EXPECT_FALSE(ring.tryPop(empty));
+}
+
+/**
+ * @brief All messages of multiple producers are consumed.
+ *
+ * @details
+ * - Multiple threads shall push more messages than their rings can hold.
+ * - Every message shall be consumed and the order of each thread shall be
+ *   kept.
+ */
+TEST(RingBackendTest, ConsumesAllMessagesInThreadOrder) {
+  constexpr int THREADS{4};
+  constexpr int MESSAGES{1000};
+  std::mutex mtx;
+  std::map<std::string, std::vector<int>> consumed;
+  {
+    helios::logger::RingBackend backend(
+        16, [&](helios::logger::LogMessage msg) {
+          auto sep = msg.body.find(':');
+          std::lock_guard<std::mutex> lock(mtx);
+          consumed[msg.body.substr(0, sep)].push_back(
+              std::stoi(msg.body.substr(sep + 1))
+          );
+        }
+    );
+    std::vector<std::thread> producers;
+    for (int t{}; t < THREADS; ++t) {
+      producers.emplace_back([&backend, t] {
+        for (int i{}; i < MESSAGES; ++i) {
+          helios::logger::LogMessage msg;
+          msg.body = std::to_string(t) + ":" + std::to_string(i);
+          backend.push(std::move(msg));
+        }
+      });
+    }
+    for (auto &producer : producers)
+      producer.join();
+  } // Destruction consumes the remaining messages
+  ASSERT_EQ(consumed.size(), static_cast<std::size_t>(THREADS));
+  for (auto &[thread, values] : consumed) {
+    ASSERT_EQ(values.size(), static_cast<std::size_t>(MESSAGES));
+    for (int i{}; i < MESSAGES; ++i)
+      EXPECT_EQ(values[i], i);
+  }
+}
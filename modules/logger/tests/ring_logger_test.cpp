@@ -0,0 +1,106 @@
+#include "logger/logger.hpp"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include "logger/log_macros.hpp"
+
+// Built against a Logger configured with the Ring backend
+
+namespace {
+
+/**
+ * @brief Redirects the standard output into a pipe during its lifetime.
+ */
+class StdoutPipe {
+public:
+  StdoutPipe() {
+    ::pipe(fds_);
+    saved_ = ::dup(1);
+    ::dup2(fds_[1], 1);
+  }
+  ~StdoutPipe() {
+    ::dup2(saved_, 1);
+    ::close(saved_);
+    ::close(fds_[0]);
+    ::close(fds_[1]);
+  }
+
+  /**
+   * @brief Reads until the output holds 'count' lines containing 'marker'.
+   *
+   * @return Number of such lines read before the timeout.
+   */
+  std::size_t waitLines(const std::string &marker, std::size_t count,
+                        std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (countLines(marker) < count) {
+      const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - std::chrono::steady_clock::now()
+      );
+      pollfd pfd{fds_[0], POLLIN, 0};
+      if (left.count() <= 0 ||
+          ::poll(&pfd, 1, static_cast<int>(left.count())) != 1)
+        break;
+      char buf[4096];
+      const auto n = ::read(fds_[0], buf, sizeof(buf));
+      if (n > 0)
+        output_.append(buf, static_cast<std::size_t>(n));
+    }
+    return countLines(marker);
+  }
+
+private:
+  int fds_[2]{-1, -1};
+  int saved_{-1};
+  std::string output_;
+
+  std::size_t countLines(const std::string &marker) const {
+    std::size_t count{0};
+    for (auto pos = output_.find(marker); pos != std::string::npos;
+         pos = output_.find(marker, pos + marker.size()))
+      ++count;
+    return count;
+  }
+}; // class StdoutPipe
+
+} // namespace
+
+/**
+ * @brief Messages of several threads reach the sinks through the rings.
+ *
+ * @details
+ * - Verifies that the consumer thread wakes up for a message logged after
+ *   it went idle.
+ */
+TEST(RingLoggerTest, MessagesReachSinks) {
+  ASSERT_TRUE(helios::logger::ENABLE_RING_BACKEND);
+  helios::logger::Logger logger_("RingLoggerTest");
+  StdoutPipe out;
+
+  constexpr std::size_t THREADS = 4;
+  constexpr std::size_t PER_THREAD = 250;
+  std::vector<std::thread> producers;
+  for (std::size_t t{}; t < THREADS; ++t) {
+    producers.emplace_back([&logger_] {
+      for (std::size_t i{}; i < PER_THREAD; ++i)
+        LOG_ERROR << "burst message " << i;
+    });
+  }
+  for (auto &p : producers)
+    p.join();
+  EXPECT_EQ(out.waitLines("burst message", THREADS * PER_THREAD,
+                          std::chrono::seconds(5)),
+            THREADS * PER_THREAD);
+
+  // The consumer sleeps by now
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  LOG_ERROR << "late message";
+  EXPECT_EQ(out.waitLines("late message", 1, std::chrono::seconds(5)), 1u);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file logdecode.cpp
+ *
+ * @brief Turns binary and memory-mapped log files back into text.
+ *
+ * @details
+ * - Usage: helios-logdecode [--from TIME] [--to TIME] [--level LEVEL]
+ *   [--tag TAG]... FILE...
+ * - TIME is either seconds since the epoch or 'YYYY-mm-ddTHH:MM:SS' in local
+ *   time. LEVEL is one of DEBUG, INFO, WARN or ERROR. '--tag' may be repeated.
+ * - Messages are printed in the format of the text sinks.
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "binary_format.hpp"
+#include "log_formatter.hpp"
+#include "mapped_sink.hpp"
+
+namespace {
+
+using namespace helios::logger;
+
+/**
+ * @brief Parses a time argument.
+ */
+std::chrono::system_clock::time_point parseTime(const std::string &s) {
+  std::tm tm{};
+  const char *end = strptime(s.c_str(), "%Y-%m-%dT%H:%M:%S", &tm);
+  if (end && *end == '\0') {
+    tm.tm_isdst = -1;
+    return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+  }
+  return std::chrono::system_clock::time_point(
+      std::chrono::seconds(std::stoll(s))
+  );
+}
+
+/**
+ * @brief Parses a level argument.
+ */
+LogLevel parseLevel(const std::string &s) {
+  for (auto lvl : {LogLevel::Debug, LogLevel::Info, LogLevel::Warning,
+                   LogLevel::Error}) {
+    if (s == levelToString(lvl))
+      return lvl;
+  }
+  throw std::invalid_argument("Unknown level: " + s);
+}
+
+/**
+ * @brief Prints the records of a memory-mapped file accepted by the filter.
+ */
+void printMapped(const std::string &file, const RecordFilter &filter) {
+  readMappedLog(file, filter, [](std::uint64_t, const LogMessage &msg) {
+    std::cout << formatText(msg);
+  });
+}
+
+void usage() {
+  std::cerr << "Usage: helios-logdecode [--from TIME] [--to TIME] "
+               "[--level LEVEL] [--tag TAG]... FILE...\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  RecordFilter filter;
+  std::vector<std::string> files;
+  try {
+    for (int i{1}; i < argc; ++i) {
+      const std::string arg = argv[i];
+      const bool hasValue = i + 1 < argc;
+      if (arg == "--from" && hasValue)
+        filter.from = parseTime(argv[++i]);
+      else if (arg == "--to" && hasValue)
+        filter.to = parseTime(argv[++i]);
+      else if (arg == "--level" && hasValue)
+        filter.minLevel = parseLevel(argv[++i]);
+      else if (arg == "--tag" && hasValue)
+        filter.tags.emplace_back(argv[++i]);
+      else if (arg.rfind("--", 0) == 0)
+        throw std::invalid_argument("Unknown option: " + arg);
+      else
+        files.push_back(arg);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (files.empty()) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  int status{EXIT_SUCCESS};
+  for (const auto &file : files) {
+    if (isMappedLog(file)) {
+      try {
+        printMapped(file, filter);
+      } catch (const std::exception &e) {
+        std::cerr << file << ": " << e.what() << '\n';
+        status = EXIT_FAILURE;
+      }
+      continue;
+    }
+    std::ifstream in(file, std::ios::binary);
+    if (!in.is_open()) {
+      std::cerr << file << ": " << std::strerror(errno) << '\n';
+      status = EXIT_FAILURE;
+      continue;
+    }
+    try {
+      BinaryDecoder decoder(in, filter);
+      LogMessage msg;
+      while (decoder.next(msg))
+        std::cout << formatText(msg);
+    } catch (const std::exception &e) {
+      std::cerr << file << ": " << e.what() << '\n';
+      status = EXIT_FAILURE;
+    }
+  }
+  return status;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+namespace helios::timesys {
+
+/**
+ * @brief What a periodic timer does with the deadlines it missed because the
+ *        timer thread was late.
+ * - Skip: Runs once, then continues on its original deadlines. The missed
+ *   deadlines are dropped.
+ * - CatchUp: Runs once for every missed deadline, back to back, but for at
+ *   most MAX_CATCH_UP of them. Older ones are dropped, so a long stall can't
+ *   turn into an unbounded batch of callbacks.
+ * - Coalesce: Runs once for all the missed deadlines and restarts its
+ *   deadlines from now.
+ */
+enum class MissedTicks { Skip, CatchUp, Coalesce };
+
+/**
+ * @brief Max number of missed deadlines a CatchUp timer runs for.
+ */
+inline constexpr std::size_t MAX_CATCH_UP = 64;
+
+} // namespace helios::timesys
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace helios::timesys {
+
+/**
+ * @class timesys::LatencyHistogram
+ *
+ * @brief Histogram of durations in power-of-two microsecond buckets.
+ *
+ * @details
+ * - Bucket 0 counts the durations below 1 us. Bucket 'k' counts the
+ *   durations in [2^(k-1), 2^k) us. The last bucket also counts everything
+ *   above it.
+ * - Recording is a few instructions and never allocates.
+ *
+ * @note
+ * - Not thread-safe.
+ */
+class LatencyHistogram {
+public:
+  /**
+   * @brief Type aliases.
+   */
+  using Duration = std::chrono::nanoseconds;
+
+  /**
+   * @brief Number of buckets. The last one starts at about 9 minutes.
+   */
+  static constexpr std::size_t BUCKETS = 32;
+
+  /**
+   * @brief Adds a sample. Negative durations count as zero.
+   */
+  void record(Duration d);
+
+  /**
+   * @brief Adds the samples of another histogram.
+   */
+  void merge(const LatencyHistogram &other);
+
+  /**
+   * @brief Removes all samples.
+   */
+  void reset() { *this = LatencyHistogram{}; }
+
+  /**
+   * @brief Returns the number of samples.
+   */
+  std::uint64_t count() const { return count_; }
+
+  /**
+   * @brief Returns the number of samples of a bucket.
+   */
+  std::uint64_t bucket(std::size_t k) const { return buckets_[k]; }
+
+  /**
+   * @brief Returns the exclusive upper bound of a bucket.
+   */
+  static Duration upperBound(std::size_t k) {
+    return std::chrono::microseconds(std::int64_t{1} << k);
+  }
+
+  /**
+   * @brief Returns the largest sample.
+   */
+  Duration max() const { return max_; }
+
+  /**
+   * @brief Returns the mean of the samples.
+   */
+  Duration mean() const {
+    return count_ == 0 ? Duration::zero()
+                       : sum_ / static_cast<Duration::rep>(count_);
+  }
+
+  /**
+   * @brief Returns an upper bound of a percentile.
+   *
+   * @param p Percentile, between 0 and 100.
+   *
+   * @return Upper bound of the bucket holding the percentile, capped at the
+   *         largest sample. Zero without samples.
+   */
+  Duration percentile(double p) const;
+
+private:
+  /**
+   * @brief Samples per bucket.
+   */
+  std::array<std::uint64_t, BUCKETS> buckets_{};
+
+  /**
+   * @brief Number of samples.
+   */
+  std::uint64_t count_{0};
+
+  /**
+   * @brief Sum of the samples.
+   */
+  Duration sum_{0};
+
+  /**
+   * @brief Largest sample.
+   */
+  Duration max_{0};
+}; // class LatencyHistogram
+
+/**
+ * @struct timesys::TimerStats
+ *
+ * @brief Snapshot of the statistics of a TimersManager.
+ */
+struct TimerStats {
+  std::size_t active{0};         // Pending timers, periodic ones included
+  std::uint64_t created{0};      // Timers created so far
+  std::uint64_t cancelled{0};    // Timers cancelled before they fired
+  std::uint64_t fired{0};        // Callbacks called, each period counts
+  LatencyHistogram lateness;     // From the deadline to the callback start
+  LatencyHistogram callbackTime; // Duration of the callbacks
+}; // struct TimerStats
+
+} // namespace helios::timesys
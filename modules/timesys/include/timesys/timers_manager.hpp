@@ -1,26 +1,75 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 
+#include "core/clock.hpp"
+#include "timesys/missed_ticks.hpp"
+#include "timesys/timer_stats.hpp"
+
 namespace helios::timesys {
 
+class TimerHandle;
+
 /**
  * @class timesys::TimersManager
  *
  * @brief Creates a separate thread which could handle multiple timers.
  *
  * @details
+ * - The pending timers are kept by one of two backends:
+ *   - Heap: A binary heap. O(log n) per timer, exact wake-ups.
+ *   - Wheel: A hierarchical timing wheel with a resolution of 1 ms. O(1) per
+ *     timer, suited to large numbers of short timeouts.
+ * - Due timers are taken out in batches and their callbacks are called
+ *   outside the lock.
+ * - Periodic timers run at 'start + k * period'. The next deadline is armed
+ *   before the callback runs, so neither the callback nor the timer thread
+ *   make the period drift.
+ * - The thread sleeps until the earliest timer in one of two ways:
+ *   - CondVar: A condition variable, notified when a new timer is the
+ *     earliest one.
+ *   - TimerFd: A Linux timer file descriptor. Adding a timer that is the
+ *     earliest one moves the kernel timer without waking the thread, and the
+ *     kernel timer is set again only if the earliest deadline changed.
+ * - Durations are measured on the clock given on construction. With a
+ *   core::VirtualClock, the timer thread is one of its participants and
+ *   simulated time jumps from one timer to the next.
+ * - A one-shot timer may be given a slack. It then fires at some point within
+ *   'duration + slack', chosen so that timers with overlapping windows fire
+ *   in one batch and wake the thread once.
+ *
+ * @note
  * - All public functions are asynchronous.
  * - All public functions are thread-safe.
  */
 class TimersManager {
 public:
+  /**
+   * @brief Containers of the pending timers.
+   */
+  enum class Backend { Heap, Wheel };
+
+  /**
+   * @brief Ways the timer thread sleeps until the next timer.
+   */
+  enum class Engine { CondVar, TimerFd };
+
   /**
    * @brief Constructor.
+   *
+   * @param backend Container of the pending timers.
+   * @param engine How the timer thread sleeps. TimerFd falls back to CondVar
+   *        if the timer file descriptor can't be created or the clock is not
+   *        a core::SteadyClock.
+   * @param clock Optional clock of the timers. Defaults to a
+   *        core::SteadyClock.
    */
-  TimersManager();
+  explicit TimersManager(Backend backend = Backend::Heap,
+                         Engine engine = Engine::CondVar,
+                         std::shared_ptr<core::Clock> clock = nullptr);
 
   /**
    * @brief Destructor.
@@ -48,10 +97,42 @@ public:
    *
    * @param duration The timer duration.
    * @param Callback The callback that is called when the duration is finished.
+   * @param slack How much later than the duration the timer may fire.
+   *
+   * @return Handle to cancel or reschedule the timer.
    */
-  void create(Duration duration, Callback cb);
+  TimerHandle create(Duration duration, Callback cb,
+                     Duration slack = Duration::zero());
+
+  /**
+   * @brief Creates a periodic timer.
+   *
+   * @param period Period of the timer. The first expiry is one period from
+   *        now.
+   * @param cb The callback that is called on every expiry.
+   * @param missed What the timer does with the deadlines it missed.
+   *
+   * @return Handle to cancel or reschedule the timer. Rescheduling moves the
+   *         next expiry and restarts the deadlines from there.
+   */
+  TimerHandle createPeriodic(Duration period, Callback cb,
+                             MissedTicks missed = MissedTicks::Skip);
+
+  /**
+   * @brief Returns the statistics of the timers.
+   *
+   * @details
+   * - Lateness is measured from the deadline a timer was armed for, its slack
+   *   included, to the start of its callback. It adds up the wake-up latency
+   *   of the thread, the lock and the callbacks that ran before it in the
+   *   same batch.
+   * - The histograms are updated once per batch.
+   */
+  TimerStats stats() const;
 
 private:
+  friend class TimerHandle;
+
   /**
    * @brief Forward declaration for the implementation class.
    */
@@ -63,4 +144,78 @@ private:
   std::unique_ptr<Impl> impl_;
 }; // class TimersManager
 
+/**
+ * @class timesys::TimerHandle
+ *
+ * @brief Refers to a timer created by a TimersManager.
+ *
+ * @details
+ * - A default constructed handle refers to no timer.
+ * - Destroying a handle does not cancel its timer.
+ * - Cancelling a timer never wakes the timer thread. The timer is removed from
+ *   the queue right away or skipped when its time comes.
+ *
+ * @note
+ * - All public functions are thread-safe.
+ * - A handle shall not be used after its TimersManager is destroyed.
+ */
+class TimerHandle {
+public:
+  /**
+   * @brief Constructs a handle that refers to no timer.
+   */
+  TimerHandle() = default;
+
+  /**
+   * @brief Cancels the timer.
+   *
+   * @details
+   * - Once it returns true, the callback does not start anymore, even if the
+   *   timer thread already took a periodic timer out for its running batch.
+   *   A callback that already started on the timer thread still completes.
+   *
+   * @return False if the timer already fired or was cancelled.
+   */
+  bool cancel();
+
+  /**
+   * @brief Moves the expiry of the timer to a new duration from now.
+   *
+   * @param newDuration Duration from now until the timer fires.
+   * @param slack How much later than the new duration the timer may fire.
+   *
+   * @return False if the timer already fired or was cancelled.
+   */
+  bool reschedule(TimersManager::Duration newDuration,
+                  TimersManager::Duration slack =
+                      TimersManager::Duration::zero());
+
+  /**
+   * @brief Returns true if the handle refers to a timer.
+   */
+  explicit operator bool() const { return manager_ != nullptr; }
+
+private:
+  friend class TimersManager;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param manager Manager of the timer.
+   * @param id Id of the timer in the manager.
+   */
+  TimerHandle(TimersManager *manager, std::uint64_t id)
+      : manager_{manager}, id_{id} {}
+
+  /**
+   * @brief Manager of the timer.
+   */
+  TimersManager *manager_{nullptr};
+
+  /**
+   * @brief Id of the timer in the manager.
+   */
+  std::uint64_t id_{0};
+}; // class TimerHandle
+
 } // namespace helios::timesys
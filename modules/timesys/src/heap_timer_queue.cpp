@@ -0,0 +1,93 @@
+#include "heap_timer_queue.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace helios::timesys {
+
+TimerQueue::TimerId HeapTimerQueue::add(TimePoint due, Callback cb,
+                                        Duration period, MissedTicks missed) {
+  const TimerId id = ++lastId_;
+  const std::uint64_t seq = ++lastSeq_;
+  pending_.emplace(id, Pending{seq, std::move(cb), period, missed});
+  push(Entry{due, id, seq});
+  return id;
+}
+
+bool HeapTimerQueue::cancel(TimerId id) {
+  if (pending_.erase(id) == 0)
+    return false;
+  compact();
+  dropStaleTop();
+  return true;
+}
+
+bool HeapTimerQueue::reschedule(TimerId id, TimePoint due) {
+  auto it = pending_.find(id);
+  if (it == pending_.end())
+    return false;
+  it->second.seq = ++lastSeq_;
+  push(Entry{due, id, it->second.seq});
+  dropStaleTop();
+  return true;
+}
+
+std::optional<TimerQueue::TimePoint> HeapTimerQueue::nextExpiry() const {
+  if (heap_.empty())
+    return std::nullopt;
+  return heap_.front().due;
+}
+
+void HeapTimerQueue::expire(TimePoint now, std::vector<Expired> &out) {
+  while (!heap_.empty() && heap_.front().due <= now) {
+    std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+    const Entry e = heap_.back();
+    heap_.pop_back();
+    if (!isLive(e))
+      continue; // Cancelled or rescheduled
+    auto it = pending_.find(e.id);
+    Pending &p = it->second;
+    if (p.period <= Duration::zero()) {
+      out.push_back(Expired{e.due, e.id, std::move(p.cb)});
+      pending_.erase(it);
+      continue;
+    }
+    // Armed before the callback runs, against the deadline and not the time
+    // it ran, so the period doesn't drift
+    out.push_back(Expired{e.due, e.id, p.cb});
+    p.seq = ++lastSeq_;
+    push(Entry{nextDeadline(e.due, now, p.period, p.missed), e.id, p.seq});
+  }
+  dropStaleTop();
+}
+
+bool HeapTimerQueue::isLive(const Entry &e) const {
+  auto it = pending_.find(e.id);
+  return it != pending_.end() && it->second.seq == e.seq;
+}
+
+void HeapTimerQueue::push(Entry e) {
+  compact();
+  heap_.push_back(e);
+  std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+}
+
+void HeapTimerQueue::compact() {
+  // Rebuild once the stale entries outnumber the pending ones
+  if (heap_.size() <= 64 || heap_.size() <= 2 * pending_.size())
+    return;
+  heap_.erase(std::remove_if(heap_.begin(), heap_.end(),
+                             [this](const Entry &e) { return !isLive(e); }),
+              heap_.end());
+  std::make_heap(heap_.begin(), heap_.end(), std::greater<>{});
+}
+
+void HeapTimerQueue::dropStaleTop() {
+  // Keeps nextExpiry() exact
+  while (!heap_.empty() && !isLive(heap_.front())) {
+    std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+    heap_.pop_back();
+  }
+}
+
+} // namespace helios::timesys
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "timer_queue.hpp"
+
+namespace helios::timesys {
+
+/**
+ * @class timesys::HeapTimerQueue
+ *
+ * @brief Keeps the pending timers in a binary min-heap ordered by their due
+ *        time.
+ *
+ * @details
+ * - add() and expire() take O(log n) per timer. nextExpiry() is exact.
+ * - The heap holds only the due times and ids. The callbacks are kept aside,
+ *   so reordering the heap never moves a callback.
+ * - cancel() drops the callback only. The heap entry is skipped when it
+ *   reaches the top, and the heap is rebuilt once most entries are stale.
+ * - reschedule() pushes a new entry and leaves the old one stale.
+ */
+class HeapTimerQueue : public TimerQueue {
+public:
+  TimerId add(TimePoint due, Callback cb, Duration period = Duration::zero(),
+              MissedTicks missed = MissedTicks::Skip) override;
+  bool cancel(TimerId id) override;
+  bool reschedule(TimerId id, TimePoint due) override;
+  std::optional<TimePoint> nextExpiry() const override;
+  void expire(TimePoint now, std::vector<Expired> &out) override;
+  std::size_t size() const override { return pending_.size(); }
+
+private:
+  /**
+   * @brief Heap entry of a timer.
+   */
+  struct Entry {
+    TimePoint due;
+    TimerId id;
+    std::uint64_t seq; // Stale if it differs from the seq of the timer
+
+    /**
+     * @brief Orders the heap by due time, then by insertion.
+     */
+    bool operator>(const Entry &other) const {
+      return due != other.due ? due > other.due : seq > other.seq;
+    }
+  }; // struct Entry
+
+  /**
+   * @brief Heap of the timers, including stale entries.
+   */
+  std::vector<Entry> heap_;
+
+  /**
+   * @brief Pending timer.
+   */
+  struct Pending {
+    std::uint64_t seq; // Seq of its current heap entry
+    Callback cb;
+    Duration period; // Zero for one-shot timers
+    MissedTicks missed;
+  }; // struct Pending
+
+  /**
+   * @brief Pending timers by id.
+   */
+  std::unordered_map<TimerId, Pending> pending_;
+
+  /**
+   * @brief Id of the last added timer.
+   */
+  TimerId lastId_{0};
+
+  /**
+   * @brief Seq of the last pushed heap entry.
+   */
+  std::uint64_t lastSeq_{0};
+
+  /**
+   * @brief Returns true if a heap entry belongs to a pending timer.
+   */
+  bool isLive(const Entry &e) const;
+
+  /**
+   * @brief Pushes an entry.
+   */
+  void push(Entry e);
+
+  /**
+   * @brief Removes the stale entries if they are the majority.
+   */
+  void compact();
+
+  /**
+   * @brief Pops the stale entries off the top of the heap.
+   */
+  void dropStaleTop();
+}; // class HeapTimerQueue
+
+} // namespace helios::timesys
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "timesys/missed_ticks.hpp"
+
+namespace helios::timesys {
+
+/**
+ * @class timesys::TimerQueue
+ *
+ * @brief Interface of the containers holding the pending timers of a
+ *        TimersManager.
+ *
+ * @details
+ * - Timers are identified by the id returned by add(). Ids are never reused
+ *   while the timer is pending.
+ * - Due timers are taken out in batches by expire().
+ * - A periodic timer stays in the queue. Its deadlines are 'due + k * period'
+ *   so it does not drift, and expire() arms the next one before the callback
+ *   runs.
+ *
+ * @note
+ * - Not thread-safe. Protected by the TimersManager.
+ */
+class TimerQueue {
+public:
+  /**
+   * @brief Type aliases.
+   */
+  using Clock = std::chrono::steady_clock;
+  using Duration = Clock::duration;
+  using TimePoint = Clock::time_point;
+  using Callback = std::function<void()>;
+  using TimerId = std::uint64_t;
+
+  /**
+   * @brief Timer taken out by expire().
+   */
+  struct Expired {
+    TimePoint due; // Deadline it expired for
+    TimerId id;
+    Callback cb;
+  }; // struct Expired
+
+  /**
+   * @brief Virtual destructor.
+   */
+  virtual ~TimerQueue() = default;
+
+  /**
+   * @brief Adds a timer.
+   *
+   * @param due Time when the timer expires.
+   * @param cb Callback of the timer. Copied on every expiry of a periodic
+   *        timer, so it shall be cheap to copy.
+   * @param period Period of a periodic timer. Zero for a one-shot timer.
+   * @param missed What a periodic timer does with missed deadlines.
+   *
+   * @return Id of the timer.
+   */
+  virtual TimerId add(TimePoint due, Callback cb,
+                      Duration period = Duration::zero(),
+                      MissedTicks missed = MissedTicks::Skip) = 0;
+
+  /**
+   * @brief Removes a pending timer.
+   *
+   * @param id Id of the timer.
+   *
+   * @return False if the timer already expired or was cancelled.
+   */
+  virtual bool cancel(TimerId id) = 0;
+
+  /**
+   * @brief Moves the due time of a pending timer. The id stays the same.
+   *
+   * @details
+   * - The deadlines of a periodic timer restart from the new due time.
+   *
+   * @param id Id of the timer.
+   * @param due New time when the timer expires.
+   *
+   * @return False if the timer already expired or was cancelled.
+   */
+  virtual bool reschedule(TimerId id, TimePoint due) = 0;
+
+  /**
+   * @brief Returns when expire() shall be called next.
+   *
+   * @details
+   * - Never later than the time expire() takes out the earliest pending
+   *   timer, but may be earlier.
+   *
+   * @return Nothing if no timer is pending.
+   */
+  virtual std::optional<TimePoint> nextExpiry() const = 0;
+
+  /**
+   * @brief Takes out the timers due at a given time.
+   *
+   * @param now Current time.
+   * @param out Deadlines and callbacks of the due timers are appended here.
+   */
+  virtual void expire(TimePoint now, std::vector<Expired> &out) = 0;
+
+  /**
+   * @brief Returns the number of pending timers.
+   */
+  virtual std::size_t size() const = 0;
+
+protected:
+  /**
+   * @brief Returns the next deadline of a periodic timer after it expired.
+   *
+   * @param due Deadline that expired.
+   * @param now Current time.
+   * @param period Period of the timer.
+   * @param missed What the timer does with missed deadlines.
+   */
+  static TimePoint nextDeadline(TimePoint due, TimePoint now, Duration period,
+                                MissedTicks missed) {
+    const TimePoint next = due + period;
+    if (next > now)
+      return next;
+    if (missed == MissedTicks::CatchUp) {
+      // Drop the oldest deadlines so that one batch stays bounded
+      const auto behind = static_cast<std::size_t>((now - next) / period);
+      if (behind < MAX_CATCH_UP)
+        return next;
+      const auto dropped =
+          static_cast<Duration::rep>(behind - MAX_CATCH_UP + 1);
+      return next + period * dropped;
+    }
+    if (missed == MissedTicks::Coalesce)
+      return now + period;
+    return next + period * ((now - next) / period + 1);
+  }
+}; // class TimerQueue
+
+} // namespace helios::timesys
@@ -0,0 +1,44 @@
+#include "timesys/timer_stats.hpp"
+
+#include <algorithm>
+
+namespace helios::timesys {
+
+void LatencyHistogram::record(Duration d) {
+  d = std::max(d, Duration::zero());
+  const auto us = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(d).count()
+  );
+  // Bucket of 'us' is its bit width, 0 for 0
+  const std::size_t k =
+      us == 0 ? 0 : static_cast<std::size_t>(64 - __builtin_clzll(us));
+  ++buckets_[std::min(k, BUCKETS - 1)];
+  ++count_;
+  sum_ += d;
+  max_ = std::max(max_, d);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+  for (std::size_t k = 0; k < BUCKETS; ++k)
+    buckets_[k] += other.buckets_[k];
+  count_ += other.count_;
+  sum_ += other.sum_;
+  max_ = std::max(max_, other.max_);
+}
+
+LatencyHistogram::Duration LatencyHistogram::percentile(double p) const {
+  if (count_ == 0)
+    return Duration::zero();
+  const auto rank = static_cast<std::uint64_t>(
+      std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(count_)
+  );
+  std::uint64_t seen = 0;
+  for (std::size_t k = 0; k < BUCKETS; ++k) {
+    seen += buckets_[k];
+    if (seen > rank || seen == count_)
+      return std::min(upperBound(k), max_);
+  }
+  return max_;
+}
+
+} // namespace helios::timesys
@@ -1,21 +1,33 @@
 #include "timesys/timers_manager.hpp"
 
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <future>
-#include <iostream>
 #include <mutex>
-#include <queue>
+#include <optional>
 #include <thread>
+#include <vector>
 
-#include "core/active_h_object.hpp"
+#include "heap_timer_queue.hpp"
+#include "wheel_timer_queue.hpp"
 
 namespace helios::timesys {
 
-class TimersManager::Impl : public core::ActiveHObject {
+class TimersManager::Impl {
 public:
   /**
    * @brief Constructor.
+   *
+   * @param backend Container of the pending timers.
+   * @param engine How the thread sleeps until the next timer.
+   * @param clock Clock of the timers.
    */
-  Impl();
+  Impl(Backend backend, Engine engine, std::shared_ptr<core::Clock> clock);
 
   /**
    * @brief Destructor.
@@ -23,19 +35,48 @@ public:
   ~Impl();
 
   /**
-   * @brief Struct that represents a timer.
+   * @brief Clock of the timers.
+   */
+  std::shared_ptr<core::Clock> clock_;
+
+  /**
+   * @brief Pending timers.
+   */
+  std::unique_ptr<TimerQueue> q_;
+
+  /**
+   * @brief Due timers. Reused between batches.
+   */
+  std::vector<TimerQueue::Expired> expired_;
+
+  /**
+   * @brief Statistics, except the active timers taken from the queue.
+   */
+  TimerStats stats_;
+
+  /**
+   * @brief True while the thread runs a batch outside the lock.
+   */
+  bool inBatch_{false};
+
+  /**
+   * @brief Timers cancelled while the batch runs. Their callbacks in the
+   *        batch are skipped.
+   */
+  std::vector<TimerQueue::TimerId> batchCancels_;
+
+  /**
+   * @brief Set when 'batchCancels_' is not empty, so the thread only locks
+   *        to check it after a cancel.
    */
-  struct Timer {
-    Timer(TimePoint tp, Callback cb) : tp_{tp}, cb_{cb} {}
-    TimePoint tp_;
-    Callback cb_;
-    bool operator<(const Timer &other) const { return tp_ > other.tp_; }
-  }; // struct Timer
+  std::atomic<bool> hasBatchCancels_{false};
 
   /**
-   * @brief Queue of active timers.
+   * @brief Samples of the running batch. Used by the thread only, merged
+   *        into 'stats_' under the lock.
    */
-  std::priority_queue<Timer> q_;
+  LatencyHistogram batchLateness_;
+  LatencyHistogram batchCallbackTime_;
 
   /**
    * @brief Timer thread.
@@ -48,37 +89,162 @@ public:
   std::mutex mtx_;
 
   /**
-   * @brief Wakes the thread.
+   * @brief Wakes the thread of the CondVar engine.
    */
   std::condition_variable cv_;
 
+  /**
+   * @brief Timer file descriptor of the TimerFd engine. -1 for the CondVar
+   *        engine.
+   */
+  int timerFd_{-1};
+
+  /**
+   * @brief Deadline the thread sleeps until. Nothing if it sleeps without a
+   *        deadline or doesn't sleep.
+   */
+  std::optional<TimePoint> armed_;
+
   /**
    * @brief Set to true to stop the thread, false otherwise.
    */
   bool stopRunning_{false};
 
+  /**
+   * @brief Returns the latest time point up to 'due + slack' that is a
+   *        multiple of a power of two nanoseconds, but not before 'due'.
+   *
+   * @details
+   * - Timers with overlapping slack windows are moved to the same time point
+   *   and fire in one batch.
+   */
+  static TimePoint withSlack(TimePoint due, Duration slack);
+
+  /**
+   * @brief Adds a timer and wakes the thread if it is the earliest one.
+   *
+   * @return Id of the timer.
+   */
+  TimerQueue::TimerId add(Duration duration, Callback cb, Duration period,
+                          MissedTicks missed, Duration slack);
+
+  /**
+   * @brief Makes the thread wake up by a deadline if it would sleep past it.
+   *        Called with the lock held.
+   *
+   * @return True if the condition variable shall be notified.
+   */
+  bool wakeBy(TimePoint due);
+
+  /**
+   * @brief Sets the deadline of the timer file descriptor. Nothing disarms
+   *        it.
+   */
+  void setTimerFd(std::optional<TimePoint> due);
+
+  /**
+   * @brief Sleeps until the next timer or until woken. Called with the lock
+   *        held.
+   *
+   * @param lock Lock of the class.
+   * @param next Expiry of the next timer, if any.
+   */
+  void sleep(std::unique_lock<std::mutex> &lock,
+             std::optional<TimePoint> next);
+
   /**
    * @brief Main thread function.
    */
   void run();
 }; // class Impl
 
-TimersManager::TimersManager()
-    : impl_{std::make_unique<TimersManager::Impl>()} {}
+TimersManager::TimersManager(Backend backend, Engine engine,
+                             std::shared_ptr<core::Clock> clock)
+    : impl_{std::make_unique<TimersManager::Impl>(backend, engine,
+                                                  std::move(clock))} {}
 
 TimersManager::~TimersManager() = default;
 
-void TimersManager::create(Duration duration, Callback cb) {
+TimerHandle TimersManager::create(Duration duration, Callback cb,
+                                  Duration slack) {
+  return TimerHandle(this,
+                     impl_->add(duration, std::move(cb), Duration::zero(),
+                                MissedTicks::Skip, slack));
+}
+
+TimerHandle TimersManager::createPeriodic(Duration period, Callback cb,
+                                          MissedTicks missed) {
+  // Shared so that every expiry copies a pointer and not the callable
+  auto shared = std::make_shared<Callback>(std::move(cb));
+  return TimerHandle(
+      this, impl_->add(
+                period, [shared] { (*shared)(); },
+                std::max(period, Duration(1)), missed, Duration::zero()
+            )
+  );
+}
+
+TimerStats TimersManager::stats() const {
+  std::lock_guard<std::mutex> lock(impl_->mtx_);
+  TimerStats stats = impl_->stats_;
+  stats.active = impl_->q_->size();
+  return stats;
+}
+
+bool TimerHandle::cancel() {
+  if (!manager_)
+    return false;
+  // The thread isn't woken, it skips the timer if it still waits for it
+  auto &impl = *manager_->impl_;
+  std::lock_guard<std::mutex> lock(impl.mtx_);
+  if (!impl.q_->cancel(id_))
+    return false;
+  ++impl.stats_.cancelled;
+  if (impl.inBatch_) {
+    // A periodic timer may have a callback waiting in the running batch
+    impl.batchCancels_.push_back(id_);
+    impl.hasBatchCancels_.store(true, std::memory_order_release);
+  }
+  return true;
+}
+
+bool TimerHandle::reschedule(TimersManager::Duration newDuration,
+                             TimersManager::Duration slack) {
+  if (!manager_)
+    return false;
+  auto &impl = *manager_->impl_;
+  const auto due = TimersManager::Impl::withSlack(
+      impl.clock_->now() + newDuration, slack
+  );
+  bool notify;
   {
-    std::lock_guard<std::mutex> lock(impl_->mtx_);
-    impl_->q_.emplace(
-        duration + std::chrono::steady_clock::now(), std::move(cb)
-    );
+    std::lock_guard<std::mutex> lock(impl.mtx_);
+    if (!impl.q_->reschedule(id_, due))
+      return false;
+    notify = impl.wakeBy(due);
   }
-  impl_->cv_.notify_one(); // Wake the thread
+  if (notify)
+    impl.clock_->wake(impl.cv_); // Wake the thread
+  return true;
 }
 
-TimersManager::Impl::Impl() {
+TimersManager::Impl::Impl(Backend backend, Engine engine,
+                          std::shared_ptr<core::Clock> clock)
+    : clock_(clock ? std::move(clock)
+                   : std::make_shared<core::SteadyClock>()) {
+  if (backend == Backend::Wheel)
+    q_ = std::make_unique<WheelTimerQueue>(std::chrono::milliseconds(1),
+                                           clock_->now());
+  else
+    q_ = std::make_unique<HeapTimerQueue>();
+
+  // Falls back to the CondVar engine if the timer can't be created. The
+  // kernel timer only follows the steady clock.
+  if (engine == Engine::TimerFd &&
+      dynamic_cast<core::SteadyClock *>(clock_.get()) != nullptr)
+    timerFd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+  clock_->attach(cv_);
+
   std::promise<void> started;
   auto main = [this, &started] {
     started.set_value(); // Indicate that the loop thread started
@@ -92,38 +258,138 @@ TimersManager::Impl::~Impl() {
   {
     std::lock_guard<std::mutex> lock(mtx_);
     stopRunning_ = true; // Stop the thread
+    if (timerFd_ >= 0)
+      setTimerFd(TimePoint{}); // Expire right away to wake the thread
   }
-  cv_.notify_one(); // Wake the thread
-  t_.join();        // Wait for loop thread to exit
+  clock_->wake(cv_); // Wake the thread
+  t_.join();         // Wait for loop thread to exit
+  clock_->detach(cv_);
+  if (timerFd_ >= 0)
+    ::close(timerFd_);
 }
 
-void TimersManager::Impl::run() {
-  while (true) {
-    std::unique_lock<std::mutex> lock(mtx_);
+TimersManager::TimePoint TimersManager::Impl::withSlack(TimePoint due,
+                                                        Duration slack) {
+  if (slack <= Duration::zero() || due.time_since_epoch() < Duration::zero())
+    return due;
+  // Clear the low bits in which 'due' and 'due + slack' differ
+  const auto first =
+      static_cast<std::uint64_t>(due.time_since_epoch().count());
+  const auto last = first + static_cast<std::uint64_t>(slack.count());
+  const auto bit = 63 - __builtin_clzll(first ^ last);
+  const std::uint64_t aligned = last & ~((std::uint64_t{1} << bit) - 1);
+  return TimePoint(Duration(static_cast<Duration::rep>(aligned)));
+}
 
-    if (stopRunning_)
-      break;
+TimerQueue::TimerId TimersManager::Impl::add(Duration duration, Callback cb,
+                                             Duration period,
+                                             MissedTicks missed,
+                                             Duration slack) {
+  const TimePoint due = withSlack(clock_->now() + duration, slack);
+  TimerQueue::TimerId id;
+  bool notify;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    id = q_->add(due, std::move(cb), period, missed);
+    ++stats_.created;
+    notify = wakeBy(due);
+  }
+  if (notify)
+    clock_->wake(cv_); // Wake the thread
+  return id;
+}
 
-    if (q_.empty()) {
-      cv_.wait(lock, [this] { return stopRunning_ || !q_.empty(); });
-      if (stopRunning_)
-        break;
-    }
+bool TimersManager::Impl::wakeBy(TimePoint due) {
+  if (armed_ && *armed_ <= due)
+    return false; // The thread wakes up in time anyway
+  armed_ = due;
+  if (timerFd_ < 0)
+    return true;
+  setTimerFd(due); // Moves the kernel timer, the thread keeps sleeping
+  return false;
+}
 
-    Timer top = q_.top();
-    auto now = SteadyClock::now();
+void TimersManager::Impl::setTimerFd(std::optional<TimePoint> due) {
+  itimerspec spec{};
+  if (due) {
+    // A zero value disarms the timer, so the past is clamped to 1 ns
+    const auto ns = std::max<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            due->time_since_epoch()
+        )
+            .count(),
+        1
+    );
+    spec.it_value.tv_sec = static_cast<time_t>(ns / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
+  }
+  ::timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
 
-    if (top.tp_ <= now) {
-      q_.pop();
-      lock.unlock();
-      top.cb_();
+void TimersManager::Impl::sleep(std::unique_lock<std::mutex> &lock,
+                                std::optional<TimePoint> next) {
+  if (timerFd_ < 0) {
+    armed_ = next;
+    clock_->sleep(lock, cv_, next);
+    armed_.reset();
+    return;
+  }
+
+  // Only touch the kernel timer if the earliest deadline changed
+  if (armed_ != next) {
+    setTimerFd(next);
+    armed_ = next;
+  }
+  lock.unlock();
+  std::uint64_t expirations;
+  const ssize_t n = ::read(timerFd_, &expirations, sizeof(expirations));
+  lock.lock();
+  if (n > 0)
+    armed_.reset(); // The kernel timer expired and is disarmed
+}
+
+void TimersManager::Impl::run() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (!stopRunning_) {
+    const auto next = q_->nextExpiry();
+    const auto now = clock_->now();
+    if (!next || *next > now) {
+      // Woken early by a new timer or the destructor, then re-evaluated
+      sleep(lock, next);
       continue;
     }
 
-    cv_.wait_until(lock, top.tp_, [this, &top] {
-      return stopRunning_ || q_.top().tp_ < top.tp_;
-    });
+    // Call the whole batch outside the lock
+    q_->expire(now, expired_);
+    inBatch_ = true;
+    lock.unlock();
+    std::size_t fired{0};
+    auto start = clock_->now();
+    for (auto &e : expired_) {
+      if (hasBatchCancels_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> cancelLock(mtx_);
+        if (std::find(batchCancels_.begin(), batchCancels_.end(), e.id) !=
+            batchCancels_.end())
+          continue;
+      }
+      batchLateness_.record(start - e.due);
+      e.cb();
+      ++fired;
+      const auto end = clock_->now();
+      batchCallbackTime_.record(end - start);
+      start = end;
+    }
+    lock.lock();
+    inBatch_ = false;
+    batchCancels_.clear();
+    hasBatchCancels_.store(false, std::memory_order_relaxed);
+    stats_.fired += fired;
+    stats_.lateness.merge(batchLateness_);
+    stats_.callbackTime.merge(batchCallbackTime_);
+    batchLateness_.reset();
+    batchCallbackTime_.reset();
+    expired_.clear();
   }
-};
+}
 
 } // namespace helios::timesys
@@ -0,0 +1,232 @@
+#include "wheel_timer_queue.hpp"
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Returns the distance from slot 'from' to the next set bit of
+ *        'mask' in circular order, between 1 and 64. 'mask' shall not be 0.
+ */
+unsigned nextSlotDistance(std::uint64_t mask, unsigned from) {
+  const unsigned shift = (from + 1) & 63;
+  const std::uint64_t rotated =
+      shift == 0 ? mask : (mask >> shift) | (mask << (64 - shift));
+  return static_cast<unsigned>(__builtin_ctzll(rotated)) + 1;
+}
+
+} // namespace
+
+namespace helios::timesys {
+
+static_assert(WheelTimerQueue::SLOTS == 64, "One bitmap word per level");
+
+WheelTimerQueue::WheelTimerQueue(Duration resolution, TimePoint start)
+    : resolution_{std::max(resolution, Duration(1))}, start_{start} {
+  heads_.fill(NIL);
+}
+
+TimerQueue::TimerId WheelTimerQueue::add(TimePoint due, Callback cb,
+                                         Duration period, MissedTicks missed) {
+  std::uint32_t index;
+  if (!free_.empty()) {
+    index = free_.back();
+    free_.pop_back();
+  } else {
+    index = static_cast<std::uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+  }
+  Node &node = nodes_[index];
+  node.tick = tickOf(due);
+  node.cb = std::move(cb);
+  node.due = due;
+  node.period = period;
+  node.missed = missed;
+  place(index);
+  ++size_;
+  return (static_cast<TimerId>(node.gen) << 32) | index;
+}
+
+bool WheelTimerQueue::cancel(TimerId id) {
+  const std::uint32_t index = find(id);
+  if (index == NIL)
+    return false;
+  unlink(index);
+  release(index);
+  return true;
+}
+
+bool WheelTimerQueue::reschedule(TimerId id, TimePoint due) {
+  const std::uint32_t index = find(id);
+  if (index == NIL)
+    return false;
+  unlink(index);
+  nodes_[index].tick = tickOf(due);
+  nodes_[index].due = due;
+  place(index);
+  return true;
+}
+
+std::optional<TimerQueue::TimePoint> WheelTimerQueue::nextExpiry() const {
+  if (size_ == 0)
+    return std::nullopt;
+  if (heads_[DUE_LIST] != NIL)
+    return timeOf(current_);
+  return timeOf(nextEventTick());
+}
+
+void WheelTimerQueue::expire(TimePoint now, std::vector<Expired> &out) {
+  collect(DUE_LIST, now, out);
+  const std::uint64_t target =
+      now > start_ ? static_cast<std::uint64_t>((now - start_) / resolution_)
+                   : 0;
+  while (size_ > 0) {
+    const std::uint64_t tick = nextEventTick();
+    if (tick > target)
+      break;
+    current_ = tick;
+    // Higher levels first, their timers may land in the lower slots
+    for (unsigned level = LEVELS - 1; level > 0; --level) {
+      if ((current_ & ((std::uint64_t{1} << (SLOT_BITS * level)) - 1)) == 0)
+        cascade(level);
+    }
+    collect(static_cast<std::uint32_t>(current_ & (SLOTS - 1)), now, out);
+    collect(DUE_LIST, now, out);
+  }
+  current_ = std::max(current_, target);
+  // Periodic timers catching up on missed deadlines
+  while (heads_[DUE_LIST] != NIL)
+    collect(DUE_LIST, now, out);
+}
+
+std::uint32_t WheelTimerQueue::find(TimerId id) const {
+  const auto index = static_cast<std::uint32_t>(id);
+  const auto gen = static_cast<std::uint32_t>(id >> 32);
+  if (index >= nodes_.size() || nodes_[index].gen != gen ||
+      nodes_[index].list == NIL)
+    return NIL;
+  return index;
+}
+
+std::uint64_t WheelTimerQueue::tickOf(TimePoint tp) const {
+  if (tp <= start_)
+    return 0;
+  const auto ticks = (tp - start_ + resolution_ - Duration(1)) / resolution_;
+  return static_cast<std::uint64_t>(ticks);
+}
+
+std::uint64_t WheelTimerQueue::nextEventTick() const {
+  std::uint64_t next = UINT64_MAX;
+  for (unsigned level = 0; level < LEVELS; ++level) {
+    if (occupied_[level] == 0)
+      continue;
+    // A slot of this level comes up when the lower bits of the tick wrap
+    const unsigned shift = SLOT_BITS * level;
+    const std::uint64_t cur = current_ >> shift;
+    const unsigned distance =
+        nextSlotDistance(occupied_[level], static_cast<unsigned>(cur & 63));
+    next = std::min(next, (cur + distance) << shift);
+  }
+  return next;
+}
+
+void WheelTimerQueue::place(std::uint32_t index) {
+  const std::uint64_t tick = nodes_[index].tick;
+  if (tick <= current_) {
+    link(index, DUE_LIST);
+    return;
+  }
+  // Timers beyond the range are parked in the farthest slot of the last level
+  constexpr std::uint64_t MAX_DELTA =
+      (std::uint64_t{1} << (SLOT_BITS * LEVELS)) - 1;
+  const std::uint64_t delta = std::min(tick - current_, MAX_DELTA);
+  unsigned level = 0;
+  while (level + 1 < LEVELS &&
+         delta >= (std::uint64_t{1} << (SLOT_BITS * (level + 1))))
+    ++level;
+  const std::uint64_t slot =
+      ((current_ + delta) >> (SLOT_BITS * level)) & (SLOTS - 1);
+  link(index, static_cast<std::uint32_t>(level * SLOTS + slot));
+}
+
+void WheelTimerQueue::link(std::uint32_t index, std::uint32_t list) {
+  Node &node = nodes_[index];
+  node.list = list;
+  node.prev = NIL;
+  node.next = heads_[list];
+  if (node.next != NIL)
+    nodes_[node.next].prev = index;
+  heads_[list] = index;
+  if (list != DUE_LIST)
+    occupied_[list / SLOTS] |= std::uint64_t{1} << (list % SLOTS);
+}
+
+void WheelTimerQueue::unlink(std::uint32_t index) {
+  Node &node = nodes_[index];
+  if (node.prev != NIL)
+    nodes_[node.prev].next = node.next;
+  else
+    heads_[node.list] = node.next;
+  if (node.next != NIL)
+    nodes_[node.next].prev = node.prev;
+  if (heads_[node.list] == NIL && node.list != DUE_LIST)
+    occupied_[node.list / SLOTS] &= ~(std::uint64_t{1} << (node.list % SLOTS));
+  node.prev = node.next = NIL;
+}
+
+void WheelTimerQueue::cascade(unsigned level) {
+  const auto slot = static_cast<std::uint32_t>(
+      (current_ >> (SLOT_BITS * level)) & (SLOTS - 1)
+  );
+  const std::uint32_t list = level * SLOTS + slot;
+  std::uint32_t index = heads_[list];
+  heads_[list] = NIL;
+  occupied_[level] &= ~(std::uint64_t{1} << slot);
+  while (index != NIL) {
+    const std::uint32_t next = nodes_[index].next;
+    place(index);
+    index = next;
+  }
+}
+
+void WheelTimerQueue::collect(std::uint32_t list, TimePoint now,
+                              std::vector<Expired> &out) {
+  // Oldest first, the list is in reverse order of insertion
+  std::uint32_t index = heads_[list];
+  if (index == NIL)
+    return;
+  while (nodes_[index].next != NIL)
+    index = nodes_[index].next;
+  heads_[list] = NIL;
+  if (list != DUE_LIST)
+    occupied_[list / SLOTS] &= ~(std::uint64_t{1} << (list % SLOTS));
+  while (index != NIL) {
+    Node &node = nodes_[index];
+    const std::uint32_t prev = node.prev;
+    const TimerId id = (static_cast<TimerId>(node.gen) << 32) | index;
+    if (node.period <= Duration::zero()) {
+      out.push_back(Expired{node.due, id, std::move(node.cb)});
+      release(index);
+    } else {
+      // Armed before the callback runs, against the deadline and not the
+      // time it ran, so the period doesn't drift
+      out.push_back(Expired{node.due, id, node.cb});
+      node.due = nextDeadline(node.due, now, node.period, node.missed);
+      node.tick = tickOf(node.due);
+      place(index);
+    }
+    index = prev;
+  }
+}
+
+void WheelTimerQueue::release(std::uint32_t index) {
+  Node &node = nodes_[index];
+  node.cb = nullptr;
+  node.list = NIL;
+  node.prev = node.next = NIL;
+  ++node.gen;
+  free_.push_back(index);
+  --size_;
+}
+
+} // namespace helios::timesys
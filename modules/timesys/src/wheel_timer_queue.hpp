@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "timer_queue.hpp"
+
+namespace helios::timesys {
+
+/**
+ * @class timesys::WheelTimerQueue
+ *
+ * @brief Keeps the pending timers in a hierarchical timing wheel.
+ *
+ * @details
+ * - Time is counted in ticks of a fixed resolution. Due times are rounded up
+ *   to the next tick, so a timer never expires early, but it may expire up to
+ *   one tick late.
+ * - The wheel has LEVELS levels of SLOTS slots. A slot of level 'l' spans
+ *   SLOTS^l ticks. A timer is put into the lowest level whose range covers it
+ *   and moves down a level whenever its slot comes up (cascading).
+ * - add(), cancel() and reschedule() are O(1). The timers are kept in a slab
+ *   and linked into their slot, so nothing is allocated once the slab has
+ *   grown.
+ * - expire() jumps straight to the next occupied slot using a bitmap of the
+ *   occupied slots of each level, and takes out whole slots at once.
+ * - Timers further away than the range of the wheel are parked in the last
+ *   level and placed again when their slot comes up.
+ */
+class WheelTimerQueue : public TimerQueue {
+public:
+  /**
+   * @brief Number of bits of the slot index of a level.
+   */
+  static constexpr unsigned SLOT_BITS = 6;
+
+  /**
+   * @brief Number of slots of each level.
+   */
+  static constexpr std::uint32_t SLOTS = 1u << SLOT_BITS;
+
+  /**
+   * @brief Number of levels. Covers 2^36 ticks.
+   */
+  static constexpr unsigned LEVELS = 6;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param resolution Duration of a tick.
+   * @param start Time of tick 0.
+   */
+  explicit WheelTimerQueue(Duration resolution = std::chrono::milliseconds(1),
+                           TimePoint start = Clock::now());
+
+  TimerId add(TimePoint due, Callback cb, Duration period = Duration::zero(),
+              MissedTicks missed = MissedTicks::Skip) override;
+  bool cancel(TimerId id) override;
+  bool reschedule(TimerId id, TimePoint due) override;
+  std::optional<TimePoint> nextExpiry() const override;
+  void expire(TimePoint now, std::vector<Expired> &out) override;
+  std::size_t size() const override { return size_; }
+
+private:
+  /**
+   * @brief Marks the end of a list and an unused node.
+   */
+  static constexpr std::uint32_t NIL = UINT32_MAX;
+
+  /**
+   * @brief List of the timers that are already due.
+   */
+  static constexpr std::uint32_t DUE_LIST = LEVELS * SLOTS;
+
+  /**
+   * @brief Timer in the slab.
+   */
+  struct Node {
+    std::uint64_t tick{0};
+    Callback cb;
+    TimePoint due;              // Exact deadline, the base of the next one
+    Duration period{0};         // Zero for one-shot timers
+    MissedTicks missed{MissedTicks::Skip};
+    std::uint32_t prev{NIL};
+    std::uint32_t next{NIL};
+    std::uint32_t list{NIL}; // NIL while the node is free
+    std::uint32_t gen{1};    // Bumped on every release, part of the id
+  }; // struct Node
+
+  /**
+   * @brief Duration of a tick.
+   */
+  const Duration resolution_;
+
+  /**
+   * @brief Time of tick 0.
+   */
+  const TimePoint start_;
+
+  /**
+   * @brief Last processed tick.
+   */
+  std::uint64_t current_{0};
+
+  /**
+   * @brief Number of pending timers.
+   */
+  std::size_t size_{0};
+
+  /**
+   * @brief Slab of the timers.
+   */
+  std::vector<Node> nodes_;
+
+  /**
+   * @brief Free nodes of the slab.
+   */
+  std::vector<std::uint32_t> free_;
+
+  /**
+   * @brief First node of each slot, followed by the due list.
+   */
+  std::array<std::uint32_t, LEVELS * SLOTS + 1> heads_;
+
+  /**
+   * @brief Bitmap of the non-empty slots of each level.
+   */
+  std::array<std::uint64_t, LEVELS> occupied_{};
+
+  /**
+   * @brief Returns the index of the node of a pending timer.
+   *
+   * @return NIL if the timer is not pending.
+   */
+  std::uint32_t find(TimerId id) const;
+
+  /**
+   * @brief Returns the first tick at or after a time.
+   */
+  std::uint64_t tickOf(TimePoint tp) const;
+
+  /**
+   * @brief Returns the time of a tick.
+   */
+  TimePoint timeOf(std::uint64_t tick) const {
+    return start_ + resolution_ * static_cast<Duration::rep>(tick);
+  }
+
+  /**
+   * @brief Returns the next tick when a slot is expired or cascaded.
+   *
+   * @return UINT64_MAX if all the slots are empty.
+   */
+  std::uint64_t nextEventTick() const;
+
+  /**
+   * @brief Links a node into the list matching its tick.
+   */
+  void place(std::uint32_t index);
+
+  /**
+   * @brief Links a node into a list.
+   */
+  void link(std::uint32_t index, std::uint32_t list);
+
+  /**
+   * @brief Unlinks a node from its list.
+   */
+  void unlink(std::uint32_t index);
+
+  /**
+   * @brief Places again the nodes of a slot of a higher level.
+   */
+  void cascade(unsigned level);
+
+  /**
+   * @brief Moves the timers of a list into 'out'. Frees the nodes of the
+   *        one-shot timers and arms the periodic ones again.
+   */
+  void collect(std::uint32_t list, TimePoint now, std::vector<Expired> &out);
+
+  /**
+   * @brief Returns a node to the slab.
+   */
+  void release(std::uint32_t index);
+}; // class WheelTimerQueue
+
+} // namespace helios::timesys
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "heap_timer_queue.hpp"
+#include "wheel_timer_queue.hpp"
+
+using namespace std::chrono_literals;
+using helios::timesys::TimerQueue;
+
+namespace {
+
+/**
+ * @brief Start time shared by the queues under test.
+ */
+const TimerQueue::TimePoint START = TimerQueue::Clock::now();
+
+/**
+ * @brief Creates a queue under test.
+ */
+template <typename Q> std::unique_ptr<TimerQueue> makeQueue() {
+  if constexpr (std::is_same_v<Q, helios::timesys::WheelTimerQueue>)
+    return std::make_unique<Q>(1ms, START);
+  else
+    return std::make_unique<Q>();
+}
+
+template <typename Q> class TimerQueueTest : public ::testing::Test {
+protected:
+  std::unique_ptr<TimerQueue> q_{makeQueue<Q>()};
+
+  /**
+   * @brief Expires the queue and calls the due callbacks.
+   */
+  void expire(TimerQueue::TimePoint now) {
+    std::vector<TimerQueue::Expired> due;
+    q_->expire(now, due);
+    for (auto &e : due) {
+      EXPECT_LE(e.due, now);
+      e.cb();
+    }
+  }
+};
+
+using Queues = ::testing::Types<helios::timesys::HeapTimerQueue,
+                                helios::timesys::WheelTimerQueue>;
+TYPED_TEST_SUITE(TimerQueueTest, Queues);
+
+} // namespace
+
+/**
+ * @brief Timers expire in order of their due time, never early.
+ */
+TYPED_TEST(TimerQueueTest, ExpiresInOrder) {
+  std::vector<int> fired;
+  this->q_->add(START + 30ms, [&] { fired.push_back(3); });
+  this->q_->add(START + 10ms, [&] { fired.push_back(1); });
+  this->q_->add(START + 20ms, [&] { fired.push_back(2); });
+  EXPECT_EQ(this->q_->size(), 3u);
+  ASSERT_TRUE(this->q_->nextExpiry());
+  EXPECT_LE(*this->q_->nextExpiry(), START + 10ms);
+
+  this->expire(START + 9ms);
+  EXPECT_TRUE(fired.empty());
+  this->expire(START + 20ms);
+  EXPECT_EQ(fired, (std::vector<int>{1, 2}));
+  this->expire(START + 1h);
+  EXPECT_EQ(fired, (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(this->q_->size(), 0u);
+  EXPECT_FALSE(this->q_->nextExpiry());
+}
+
+/**
+ * @brief Cancelled timers never fire and their ids can't be cancelled twice.
+ */
+TYPED_TEST(TimerQueueTest, Cancel) {
+  int fired{0};
+  const auto a = this->q_->add(START + 5ms, [&] { fired += 1; });
+  const auto b = this->q_->add(START + 5ms, [&] { fired += 10; });
+  EXPECT_TRUE(this->q_->cancel(a));
+  EXPECT_FALSE(this->q_->cancel(a));
+  EXPECT_EQ(this->q_->size(), 1u);
+  this->expire(START + 5ms);
+  EXPECT_EQ(fired, 10);
+  EXPECT_FALSE(this->q_->cancel(b));
+  // A new timer may reuse the storage but not the id
+  this->q_->add(START + 6ms, [&] { fired += 100; });
+  EXPECT_FALSE(this->q_->cancel(a));
+  this->expire(START + 6ms);
+  EXPECT_EQ(fired, 110);
+}
+
+/**
+ * @brief Rescheduled timers keep their id and fire once at the new time.
+ */
+TYPED_TEST(TimerQueueTest, Reschedule) {
+  std::vector<int> fired;
+  const auto a = this->q_->add(START + 10ms, [&] { fired.push_back(1); });
+  this->q_->add(START + 20ms, [&] { fired.push_back(2); });
+  EXPECT_TRUE(this->q_->reschedule(a, START + 30ms));
+  EXPECT_TRUE(this->q_->reschedule(a, START + 5s));
+  EXPECT_TRUE(this->q_->reschedule(a, START + 30ms));
+  EXPECT_EQ(this->q_->size(), 2u);
+  this->expire(START + 25ms);
+  EXPECT_EQ(fired, (std::vector<int>{2}));
+  this->expire(START + 1h);
+  EXPECT_EQ(fired, (std::vector<int>{2, 1}));
+  EXPECT_FALSE(this->q_->reschedule(a, START + 2h));
+  EXPECT_FALSE(this->q_->cancel(a));
+}
+
+/**
+ * @brief Periodic timers stay on their deadlines and handle missed ones by
+ *        their policy.
+ */
+TYPED_TEST(TimerQueueTest, Periodic) {
+  using helios::timesys::MissedTicks;
+  for (auto missed :
+       {MissedTicks::Skip, MissedTicks::CatchUp, MissedTicks::Coalesce}) {
+    this->q_ = makeQueue<TypeParam>();
+    int runs{0};
+    const auto id = this->q_->add(START + 10ms, [&] { ++runs; }, 10ms, missed);
+    this->expire(START + 10ms);
+    EXPECT_EQ(runs, 1);
+    EXPECT_EQ(this->q_->nextExpiry(), START + 20ms);
+
+    // Late by 25 ms: the deadlines 20, 30 and 40 are missed
+    this->expire(START + 45ms);
+    EXPECT_EQ(runs, missed == MissedTicks::CatchUp ? 4 : 2);
+    EXPECT_EQ(this->q_->nextExpiry(),
+              START + (missed == MissedTicks::Coalesce ? 55ms : 50ms));
+    EXPECT_EQ(this->q_->size(), 1u);
+
+    EXPECT_TRUE(this->q_->reschedule(id, START + 100ms));
+    this->expire(START + 100ms);
+    EXPECT_EQ(this->q_->nextExpiry(), START + 110ms);
+    EXPECT_TRUE(this->q_->cancel(id));
+    EXPECT_FALSE(this->q_->nextExpiry());
+  }
+}
+
+/**
+ * @brief A CatchUp timer runs for at most MAX_CATCH_UP missed deadlines in
+ *        one batch.
+ */
+TYPED_TEST(TimerQueueTest, CatchUpIsBounded) {
+  using helios::timesys::MAX_CATCH_UP;
+  int runs{0};
+  this->q_->add(START + 1ms, [&] { ++runs; }, 1ms,
+                helios::timesys::MissedTicks::CatchUp);
+  this->expire(START + 1ms);
+  EXPECT_EQ(runs, 1);
+
+  // Late by about 1000 periods
+  runs = 0;
+  this->expire(START + 1000ms);
+  EXPECT_EQ(runs, static_cast<int>(MAX_CATCH_UP) + 1);
+  EXPECT_EQ(this->q_->nextExpiry(), START + 1001ms);
+}
+
+/**
+ * @brief Random timers, far and near, expire within one tick of their due
+ *        time while time advances in random steps.
+ */
+TYPED_TEST(TimerQueueTest, RandomTimers) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<long> dueDist(0, 10'000'000);
+  std::map<int, TimerQueue::TimePoint> pending;
+  std::vector<TimerQueue::TimerId> ids;
+  auto now = START;
+  for (int i{}; i < 2000; ++i) {
+    const auto due = START + std::chrono::microseconds(dueDist(rng) *
+                                                       (i % 7 == 0 ? 100 : 1));
+    pending[i] = due;
+    ids.push_back(this->q_->add(due, [&, i] {
+      EXPECT_GE(now, pending[i]);
+      EXPECT_LT(now - pending[i], 2ms);
+      pending.erase(i);
+    }));
+  }
+  for (int i{}; i < 2000; i += 3) {
+    if (this->q_->cancel(ids[i]))
+      pending.erase(i);
+  }
+  while (this->q_->size() > 0) {
+    const auto next = this->q_->nextExpiry();
+    ASSERT_TRUE(next);
+    for (const auto &[i, due] : pending)
+      ASSERT_LE(*next, due + 1ms); // The wheel rounds up to its tick
+    now = std::max(now, *next);
+    this->expire(now);
+  }
+  EXPECT_TRUE(pending.empty());
+}
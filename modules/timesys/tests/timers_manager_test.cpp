@@ -1,8 +1,12 @@
 #include "timesys/timers_manager.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <future>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 /**
@@ -47,3 +51,251 @@ TEST(TimersManagerTest, MultipleTimersFire) {
     EXPECT_GE(finish - timer->start, std::chrono::milliseconds(10));
   }
 }
+
+/**
+ * @brief Verifies that many timers of the wheel backend fire, in order of
+ *        their durations.
+ */
+TEST(TimersManagerTest, WheelBackendFires) {
+  helios::timesys::TimersManager t(
+      helios::timesys::TimersManager::Backend::Wheel
+  );
+  constexpr int COUNT{1000};
+  std::mutex mtx;
+  std::vector<int> fired;
+  std::promise<void> done;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i{}; i < COUNT; ++i) {
+    t.create(std::chrono::milliseconds(20 + (i % 10) * 10), [&, i] {
+      std::lock_guard<std::mutex> lock(mtx);
+      fired.push_back(i % 10);
+      if (fired.size() == COUNT)
+        done.set_value();
+    });
+  }
+  done.get_future().get();
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(110));
+  EXPECT_TRUE(std::is_sorted(fired.begin(), fired.end()));
+}
+
+/**
+ * @brief Verifies that cancelled timers don't fire and rescheduled timers
+ *        fire at their new time.
+ */
+TEST(TimersManagerTest, CancelAndReschedule) {
+  for (auto backend : {helios::timesys::TimersManager::Backend::Heap,
+                       helios::timesys::TimersManager::Backend::Wheel}) {
+    helios::timesys::TimersManager t(backend);
+    std::atomic<int> cancelled{0};
+    auto handle = t.create(std::chrono::milliseconds(20), [&] {
+      ++cancelled;
+    });
+    EXPECT_TRUE(handle.cancel());
+    EXPECT_FALSE(handle.cancel());
+
+    std::promise<std::chrono::steady_clock::time_point> pr;
+    const auto start = std::chrono::steady_clock::now();
+    auto moved = t.create(std::chrono::seconds(10), [&] {
+      pr.set_value(std::chrono::steady_clock::now());
+    });
+    EXPECT_TRUE(moved.reschedule(std::chrono::milliseconds(30)));
+    const auto finish = pr.get_future().get();
+    EXPECT_GE(finish - start, std::chrono::milliseconds(30));
+    EXPECT_LT(finish - start, std::chrono::seconds(5));
+    EXPECT_FALSE(moved.reschedule(std::chrono::milliseconds(1)));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(cancelled, 0);
+    EXPECT_FALSE(helios::timesys::TimerHandle().cancel());
+  }
+}
+
+/**
+ * @brief Verifies that a periodic timer cancelled by a callback of the same
+ *        batch does not run anymore.
+ */
+TEST(TimersManagerTest, CancelSkipsCallbackOfRunningBatch) {
+  using namespace std::chrono;
+  using helios::timesys::TimerHandle;
+  for (auto backend : {helios::timesys::TimersManager::Backend::Heap,
+                       helios::timesys::TimersManager::Backend::Wheel}) {
+    auto clock = std::make_shared<helios::core::VirtualClock>();
+    helios::timesys::TimersManager t(
+        backend, helios::timesys::TimersManager::Engine::CondVar, clock
+    );
+    TimerHandle periodic;
+    std::atomic<bool> cancelled{false};
+    std::atomic<int> periodicRuns{0};
+    std::promise<void> done;
+    // Created on the timer thread, so the clock can't advance in between
+    // and both are due in the same batch, the canceller first
+    t.create(minutes(1), [&] {
+      t.create(minutes(1), [&] { cancelled = periodic.cancel(); });
+      periodic = t.createPeriodic(minutes(1), [&] { ++periodicRuns; });
+      t.create(minutes(2), [&] { done.set_value(); });
+    });
+    done.get_future().get();
+    EXPECT_TRUE(cancelled);
+    EXPECT_EQ(periodicRuns, 0);
+  }
+}
+
+/**
+ * @brief Verifies that a periodic timer fires on its deadlines although its
+ *        callback takes time.
+ */
+TEST(TimersManagerTest, PeriodicTimerDoesNotDrift) {
+  using namespace std::chrono;
+  helios::timesys::TimersManager t;
+  constexpr int COUNT{20};
+  constexpr auto PERIOD = milliseconds(5);
+  std::mutex mtx;
+  std::vector<steady_clock::time_point> fired;
+  std::promise<void> done;
+  const auto start = steady_clock::now();
+  auto handle = t.createPeriodic(PERIOD, [&] {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      if (fired.size() == COUNT)
+        return;
+      fired.push_back(steady_clock::now());
+      if (fired.size() == COUNT)
+        done.set_value();
+    }
+    std::this_thread::sleep_for(milliseconds(1)); // Latency of the callback
+  });
+  done.get_future().get();
+  EXPECT_TRUE(handle.cancel());
+  std::lock_guard<std::mutex> lock(mtx);
+  for (int k{}; k < COUNT; ++k)
+    EXPECT_GE(fired[k] - start, PERIOD * (k + 1));
+  // Re-arming from the callback would drift by 20 ms of callback latency
+  EXPECT_LT(fired.back() - start, PERIOD * COUNT + milliseconds(15));
+}
+
+/**
+ * @brief Verifies that the TimerFd engine fires timers with a slack within
+ *        their window, and wakes up for a new earlier timer.
+ */
+TEST(TimersManagerTest, TimerFdEngineFiresWithinSlack) {
+  using namespace std::chrono;
+  using helios::timesys::TimersManager;
+  TimersManager t(TimersManager::Backend::Heap, TimersManager::Engine::TimerFd);
+  constexpr int COUNT{50};
+  constexpr auto SLACK = milliseconds(20);
+  std::mutex mtx;
+  std::vector<steady_clock::duration> late;
+  std::promise<void> done;
+  const auto start = steady_clock::now();
+  // Created last but due first, it moves the kernel timer earlier
+  std::promise<steady_clock::time_point> early;
+  t.create(seconds(10), [] {});
+  for (int i{}; i < COUNT; ++i) {
+    const auto duration = milliseconds(20 + i % 10);
+    t.create(duration, [&, duration] {
+      std::lock_guard<std::mutex> lock(mtx);
+      late.push_back(steady_clock::now() - start - duration);
+      if (late.size() == COUNT)
+        done.set_value();
+    }, SLACK);
+  }
+  t.create(milliseconds(5), [&] { early.set_value(steady_clock::now()); });
+  EXPECT_LT(early.get_future().get() - start, milliseconds(500));
+  done.get_future().get();
+  std::lock_guard<std::mutex> lock(mtx);
+  for (const auto &l : late) {
+    EXPECT_GE(l, steady_clock::duration::zero());
+    EXPECT_LT(l, SLACK + milliseconds(200));
+  }
+}
+
+/**
+ * @brief Verifies that timers on a virtual clock fire exactly on their
+ *        deadlines, faster than real time.
+ */
+TEST(TimersManagerTest, VirtualClockRunsFasterThanRealTime) {
+  using namespace std::chrono;
+  using helios::timesys::TimersManager;
+  auto clock = std::make_shared<helios::core::VirtualClock>();
+  TimersManager t(TimersManager::Backend::Wheel,
+                  TimersManager::Engine::CondVar, clock);
+  constexpr int COUNT{60};
+  std::mutex mtx;
+  std::vector<steady_clock::time_point> fired;
+  std::promise<void> done;
+  const auto start = clock->now();
+  const auto wallStart = steady_clock::now();
+  auto handle = t.createPeriodic(minutes(1), [&] {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (fired.size() == COUNT)
+      return;
+    fired.push_back(clock->now());
+    if (fired.size() == COUNT)
+      done.set_value();
+  });
+  done.get_future().get();
+  EXPECT_TRUE(handle.cancel());
+  EXPECT_LT(steady_clock::now() - wallStart, seconds(5));
+  std::lock_guard<std::mutex> lock(mtx);
+  for (int k{}; k < COUNT; ++k)
+    EXPECT_EQ(fired[k] - start, minutes(k + 1));
+}
+
+/**
+ * @brief Verifies the buckets and percentiles of the latency histogram.
+ */
+TEST(LatencyHistogramTest, Percentiles) {
+  using namespace std::chrono;
+  helios::timesys::LatencyHistogram h;
+  EXPECT_EQ(h.percentile(99), nanoseconds::zero());
+  for (int i{}; i < 98; ++i)
+    h.record(microseconds(3)); // [2, 4) us
+  h.record(microseconds(100)); // [64, 128) us
+  h.record(milliseconds(5));
+  h.record(-microseconds(1));
+  EXPECT_EQ(h.count(), 101u);
+  EXPECT_EQ(h.bucket(0), 1u);
+  EXPECT_EQ(h.bucket(2), 98u);
+  EXPECT_EQ(h.bucket(7), 1u);
+  EXPECT_EQ(h.percentile(50), microseconds(4));
+  EXPECT_EQ(h.percentile(99), microseconds(128));
+  EXPECT_EQ(h.percentile(100), milliseconds(5));
+  EXPECT_EQ(h.max(), milliseconds(5));
+}
+
+/**
+ * @brief Verifies the counters and histograms of the statistics.
+ */
+TEST(TimersManagerTest, Stats) {
+  using namespace std::chrono;
+  helios::timesys::TimersManager t;
+  std::promise<void> done;
+  std::atomic<int> fired{0};
+  t.create(milliseconds(5), [&] { ++fired; });
+  t.create(milliseconds(10), [&] {
+    std::this_thread::sleep_for(milliseconds(2));
+    if (++fired == 2)
+      done.set_value();
+  });
+  auto cancelled = t.create(seconds(10), [] {});
+  auto periodic = t.createPeriodic(seconds(10), [] {});
+  EXPECT_TRUE(cancelled.cancel());
+  done.get_future().get();
+  EXPECT_TRUE(periodic.cancel());
+
+  // The batch is merged after its last callback returns
+  const auto deadline = steady_clock::now() + seconds(5);
+  auto stats = t.stats();
+  while (stats.fired < 2 && steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(milliseconds(1));
+    stats = t.stats();
+  }
+  EXPECT_EQ(stats.created, 4u);
+  EXPECT_EQ(stats.cancelled, 2u);
+  EXPECT_EQ(stats.fired, 2u);
+  EXPECT_EQ(stats.active, 0u);
+  EXPECT_EQ(stats.lateness.count(), 2u);
+  EXPECT_EQ(stats.callbackTime.count(), 2u);
+  EXPECT_GE(stats.callbackTime.max(), milliseconds(2));
+}
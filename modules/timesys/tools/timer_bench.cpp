@@ -0,0 +1,149 @@
+/**
+ * @file timer_bench.cpp
+ *
+ * @brief Measures how late the timers of a TimersManager fire with many
+ *        active timers.
+ *
+ * @details
+ * - Usage: helios-timerbench [--backend heap|wheel] [--engine condvar|timerfd]
+ *   [--window MS] [--max-p99 US] [COUNT]...
+ * - For every COUNT (default 10000, 100000 and 1000000) and backend (default
+ *   both), COUNT one-shot timers are created with durations spread over
+ *   [WINDOW, 2 * WINDOW) ms (default 2000) and the run waits until all have
+ *   fired.
+ * - Prints the lateness percentiles and the mean callback time of each run.
+ *   With '--max-p99', exits with a failure if a run's 99th percentile of
+ *   lateness exceeds US microseconds.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "timesys/timers_manager.hpp"
+
+namespace {
+
+using helios::timesys::TimersManager;
+using helios::timesys::TimerStats;
+
+/**
+ * @brief Converts a duration to microseconds for printing.
+ */
+double toUs(std::chrono::nanoseconds d) {
+  return std::chrono::duration<double, std::micro>(d).count();
+}
+
+/**
+ * @brief Runs one benchmark and returns the statistics of the manager.
+ */
+TimerStats run(TimersManager::Backend backend, TimersManager::Engine engine,
+               std::size_t count, std::chrono::milliseconds window) {
+  TimersManager manager(backend, engine);
+  std::mt19937_64 rng(count);
+  std::uniform_int_distribution<std::int64_t> spread(
+      0, std::chrono::duration_cast<std::chrono::microseconds>(window).count()
+  );
+  std::atomic<std::size_t> remaining{count};
+  std::promise<void> done;
+  for (std::size_t i{}; i < count; ++i) {
+    const auto duration = window + std::chrono::microseconds(spread(rng));
+    manager.create(duration, [&] {
+      if (--remaining == 0)
+        done.set_value();
+    });
+  }
+  done.get_future().get();
+  // The last batch is counted once its callbacks have returned
+  TimerStats stats = manager.stats();
+  while (stats.fired < count) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    stats = manager.stats();
+  }
+  return stats;
+}
+
+void usage() {
+  std::cerr << "Usage: helios-timerbench [--backend heap|wheel] "
+               "[--engine condvar|timerfd] [--window MS] [--max-p99 US] "
+               "[COUNT]...\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<TimersManager::Backend> backends;
+  auto engine = TimersManager::Engine::CondVar;
+  std::chrono::milliseconds window{2000};
+  double maxP99{0};
+  std::vector<std::size_t> counts;
+  try {
+    for (int i{1}; i < argc; ++i) {
+      const std::string arg = argv[i];
+      const bool hasValue = i + 1 < argc;
+      if (arg == "--backend" && hasValue) {
+        const std::string value = argv[++i];
+        if (value == "heap")
+          backends.push_back(TimersManager::Backend::Heap);
+        else if (value == "wheel")
+          backends.push_back(TimersManager::Backend::Wheel);
+        else
+          throw std::invalid_argument("Unknown backend: " + value);
+      } else if (arg == "--engine" && hasValue) {
+        const std::string value = argv[++i];
+        if (value == "condvar")
+          engine = TimersManager::Engine::CondVar;
+        else if (value == "timerfd")
+          engine = TimersManager::Engine::TimerFd;
+        else
+          throw std::invalid_argument("Unknown engine: " + value);
+      } else if (arg == "--window" && hasValue) {
+        window = std::chrono::milliseconds(std::stoll(argv[++i]));
+      } else if (arg == "--max-p99" && hasValue) {
+        maxP99 = std::stod(argv[++i]);
+      } else if (arg.rfind("--", 0) == 0) {
+        throw std::invalid_argument("Unknown option: " + arg);
+      } else {
+        counts.push_back(std::stoull(arg));
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (backends.empty())
+    backends = {TimersManager::Backend::Heap, TimersManager::Backend::Wheel};
+  if (counts.empty())
+    counts = {10000, 100000, 1000000};
+
+  std::cout << std::setw(6) << "queue" << std::setw(10) << "timers"
+            << std::setw(12) << "p50 us" << std::setw(12) << "p99 us"
+            << std::setw(12) << "p99.9 us" << std::setw(12) << "max us"
+            << std::setw(12) << "cb us" << '\n'
+            << std::fixed << std::setprecision(1);
+  int status{EXIT_SUCCESS};
+  for (auto backend : backends) {
+    for (auto count : counts) {
+      const TimerStats stats = run(backend, engine, count, window);
+      const double p99 = toUs(stats.lateness.percentile(99));
+      std::cout << std::setw(6)
+                << (backend == TimersManager::Backend::Heap ? "heap" : "wheel")
+                << std::setw(10) << stats.fired << std::setw(12)
+                << toUs(stats.lateness.percentile(50)) << std::setw(12) << p99
+                << std::setw(12) << toUs(stats.lateness.percentile(99.9))
+                << std::setw(12) << toUs(stats.lateness.max()) << std::setw(12)
+                << toUs(stats.callbackTime.mean()) << '\n';
+      if (maxP99 > 0 && p99 > maxP99)
+        status = EXIT_FAILURE;
+    }
+  }
+  return status;
+}